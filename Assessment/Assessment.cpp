@@ -0,0 +1,1377 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "../CpuJitter/Config.h"
+#include "../CpuJitter/CaptureReader.h"
+#include "../CpuJitter/CryptoRandomException.h"
+#include "../CpuJitter/MappedFile.h"
+
+// Offline SP 800-90B assessment of raw noise captures (NoiseCapture files) or of raw CJP output files (FileStream files).
+// The input is split into chunks that are decoded from the memory mapping by worker threads, so a file larger than the physical memory
+// is assessed in place; every chunk is run through the non-IID estimator battery of section 6.3 and the permutation test of section 5.1
+// is run on the first chunk, with the permutations spread over the threads.
+//
+// Usage: Assessment <file> [-b bits] [-c chunk symbols] [-n max chunks] [-p permutations] [-t threads]
+
+namespace
+{
+	const size_t CHUNK_SAMPLES = 1000000;
+	// the suffix array indexes a chunk with 32bit signed offsets, and the bitstring of an 8 bit chunk is eight times its length
+	const size_t CHUNK_MAXIMUM = static_cast<size_t>(std::numeric_limits<int32_t>::max()) / 8;
+	const size_t PERMUTATION_COUNT = 10000;
+	// the two sided 99% normal quantile used by the confidence bounds of SP 800-90B
+	const double NORMAL_Z99 = 2.576;
+	const double NOT_APPLICABLE = std::numeric_limits<double>::quiet_NaN();
+
+	enum Estimators : size_t
+	{
+		MostCommon = 0,
+		TTuple,
+		LongestRepeat,
+		MultiMcw,
+		Lag,
+		MultiMmc,
+		Lz78y,
+		BitMostCommon,
+		BitCollision,
+		BitMarkov,
+		BitCompression,
+		EstimatorCount
+	};
+
+	const char* ESTIMATOR_NAMES[EstimatorCount] =
+	{
+		"Most common value (6.3.1)",
+		"t-Tuple (6.3.5)",
+		"Longest repeated substring (6.3.6)",
+		"MultiMCW prediction (6.3.7)",
+		"Lag prediction (6.3.8)",
+		"MultiMMC prediction (6.3.9)",
+		"LZ78Y prediction (6.3.10)",
+		"Most common value (6.3.1)",
+		"Collision (6.3.2)",
+		"Markov (6.3.3)",
+		"Compression (6.3.4)"
+	};
+
+	enum Statistics : size_t
+	{
+		Excursion = 0,
+		DirectionalRuns,
+		DirectionalRunLength,
+		IncreasesDecreases,
+		MedianRuns,
+		MedianRunLength,
+		AverageCollision,
+		MaximumCollision,
+		Periodicity1,
+		Periodicity2,
+		Periodicity8,
+		Periodicity16,
+		Periodicity32,
+		Covariance1,
+		Covariance2,
+		Covariance8,
+		Covariance16,
+		Covariance32,
+		StatisticCount
+	};
+
+	const char* STATISTIC_NAMES[StatisticCount] =
+	{
+		"Excursion", "Directional runs", "Directional run length", "Increases/decreases", "Median runs", "Median run length",
+		"Average collision", "Maximum collision", "Periodicity lag 1", "Periodicity lag 2", "Periodicity lag 8", "Periodicity lag 16",
+		"Periodicity lag 32", "Covariance lag 1", "Covariance lag 2", "Covariance lag 8", "Covariance lag 16", "Covariance lag 32"
+	};
+
+	const size_t STATISTIC_LAGS[5] = { 1, 2, 8, 16, 32 };
+
+	//~~~Input~~~//
+
+	struct Source
+	{
+		size_t Bits;
+		CpuJitter::CaptureReader Capture;
+		bool IsCapture;
+		CpuJitter::MappedFile Raw;
+		uint64_t Symbols;
+	};
+
+	byte FoldDelta(uint64_t Delta, size_t Bits)
+	{
+		// bit i of the delta is added to bit (i mod Bits), as the CJP fold; eight bits are the harvest symbol, one bit the default folded bit
+		const uint64_t MASK = (static_cast<uint64_t>(1) << Bits) - 1;
+		uint64_t folded = 0;
+
+		while (Delta != 0)
+		{
+			folded ^= Delta & MASK;
+			Delta >>= Bits;
+		}
+
+		return static_cast<byte>(folded);
+	}
+
+	void LoadChunk(Source &Input, uint64_t First, size_t Count, std::vector<byte> &Symbols)
+	{
+		Symbols.resize(Count);
+
+		if (Input.IsCapture)
+		{
+			std::vector<uint64_t> deltas;
+			Input.Capture.Read(First, Count, deltas);
+
+			for (size_t i = 0; i < Count; ++i)
+				Symbols[i] = FoldDelta(deltas[i], Input.Bits);
+		}
+		else if (Input.Bits == 1)
+		{
+			// one bit symbols are the bits of each byte, most significant first
+			const byte* data = Input.Raw.Data();
+
+			for (size_t i = 0; i < Count; ++i)
+			{
+				const uint64_t BITPOS = First + i;
+				Symbols[i] = (data[BITPOS / 8] >> (7 - (BITPOS % 8))) & 1;
+			}
+		}
+		else
+		{
+			// narrower symbols are the low bits of each byte
+			const byte MASK = static_cast<byte>((1U << Input.Bits) - 1);
+			const byte* data = Input.Raw.Data() + First;
+
+			for (size_t i = 0; i < Count; ++i)
+				Symbols[i] = data[i] & MASK;
+		}
+	}
+
+	void ToBits(const std::vector<byte> &Symbols, size_t Bits, std::vector<byte> &Output)
+	{
+		// the bitstring of a non-binary chunk, most significant bit of each symbol first
+		Output.resize(Symbols.size() * Bits);
+
+		for (size_t i = 0; i < Symbols.size(); ++i)
+		{
+			for (size_t j = 0; j < Bits; ++j)
+				Output[i * Bits + j] = (Symbols[i] >> (Bits - 1 - j)) & 1;
+		}
+	}
+
+	//~~~Estimator Helpers~~~//
+
+	double UpperBound(double Probability, size_t Samples)
+	{
+		return (std::min)(1.0, Probability + NORMAL_Z99 * std::sqrt(Probability * (1.0 - Probability) / (Samples - 1)));
+	}
+
+	double MinEntropy(double Probability)
+	{
+		// a certain outcome is zero bits; -log2(1) is negative zero and would print as -0.0000
+		return (Probability >= 1.0) ? 0.0 : -std::log2(Probability);
+	}
+
+	double LocalPrediction(size_t LongestRun, size_t Predictions)
+	{
+		// SP 800-90B 6.3.7 step 10; the p for which the probability of no run longer than the longest observed is 0.99, solved by bisection in the log domain
+		const double RUNLEN = static_cast<double>(LongestRun + 1);
+		const double PRDCNT = static_cast<double>(Predictions);
+		double low = 0.0;
+		double high = 1.0;
+
+		for (size_t i = 0; i < 64; ++i)
+		{
+			const double PRB = (low + high) / 2.0;
+			const double QRB = 1.0 - PRB;
+			double x = 1.0;
+
+			for (size_t j = 0; j < 1000; ++j)
+			{
+				const double NEXT = 1.0 + QRB * std::pow(PRB, RUNLEN) * std::pow(x, RUNLEN + 1.0);
+
+				if (std::fabs(NEXT - x) < 1e-15)
+					break;
+
+				x = NEXT;
+			}
+
+			const double NUM = 1.0 - PRB * x;
+			const double DEN = (RUNLEN + 1.0 - RUNLEN * x) * QRB;
+			const double LNF = (NUM <= 0.0 || DEN <= 0.0) ? -std::numeric_limits<double>::infinity() : std::log(NUM) - std::log(DEN) - (PRDCNT + 1.0) * std::log(x);
+
+			if (LNF > std::log(0.99))
+				low = PRB;
+			else
+				high = PRB;
+		}
+
+		return (low + high) / 2.0;
+	}
+
+	double PredictionEntropy(size_t Correct, size_t Predictions, size_t LongestRun, size_t Alphabet)
+	{
+		if (Predictions < 2)
+			return NOT_APPLICABLE;
+
+		const double PGLB = static_cast<double>(Correct) / Predictions;
+		const double PGUP = (Correct == 0) ? 1.0 - std::pow(0.01, 1.0 / Predictions) : UpperBound(PGLB, Predictions);
+		const double PLOC = LocalPrediction(LongestRun, Predictions);
+
+		return MinEntropy((std::max)((std::max)(PGUP, PLOC), 1.0 / Alphabet));
+	}
+
+	struct Scoreboard
+	{
+		size_t Correct;
+		size_t LongestRun;
+		size_t Run;
+		std::vector<size_t> Scores;
+		size_t Winner;
+
+		explicit Scoreboard(size_t Predictors)
+			:
+			Correct(0),
+			LongestRun(0),
+			Run(0),
+			Scores(Predictors, 0),
+			Winner(0)
+		{
+		}
+
+		// predictions of -1 are no prediction, which counts as a miss
+		void Update(const int* Predictions, byte Actual)
+		{
+			if (Predictions[Winner] == Actual)
+			{
+				++Correct;
+				LongestRun = (std::max)(LongestRun, ++Run);
+			}
+			else
+			{
+				Run = 0;
+			}
+
+			for (size_t i = 0; i < Scores.size(); ++i)
+			{
+				if (Predictions[i] == Actual && ++Scores[i] >= Scores[Winner])
+					Winner = i;
+			}
+		}
+	};
+
+	struct Context
+	{
+		uint64_t High;
+		uint64_t Low;
+
+		bool operator==(const Context &Other) const { return High == Other.High && Low == Other.Low; }
+	};
+
+	struct ContextHash
+	{
+		size_t operator()(const Context &Key) const
+		{
+			uint64_t hash = (Key.Low ^ (Key.High * 0x9E3779B97F4A7C15ULL)) * 0xBF58476D1CE4E5B9ULL;
+			return static_cast<size_t>(hash ^ (hash >> 31));
+		}
+	};
+
+	typedef std::vector<std::pair<byte, uint32_t>> Followers;
+	typedef std::unordered_map<Context, Followers, ContextHash> ContextMap;
+
+	// the last sixteen symbols as a 128 bit shift register
+	struct History
+	{
+		uint64_t High;
+		uint64_t Low;
+
+		History() : High(0), Low(0) {}
+
+		void Push(byte Symbol)
+		{
+			High = (High << 8) | (Low >> 56);
+			Low = (Low << 8) | Symbol;
+		}
+
+		Context Tail(size_t Length) const
+		{
+			Context key;
+			key.Low = (Length >= 8) ? Low : Low & ((static_cast<uint64_t>(1) << (8 * Length)) - 1);
+			key.High = (Length <= 8) ? 0 : (Length >= 16) ? High : High & ((static_cast<uint64_t>(1) << (8 * (Length - 8))) - 1);
+
+			return key;
+		}
+	};
+
+	int MostFrequent(const Followers &Counts, uint32_t &Count)
+	{
+		// ties go to the larger symbol
+		int symbol = -1;
+		Count = 0;
+
+		for (size_t i = 0; i < Counts.size(); ++i)
+		{
+			if (Counts[i].second > Count || (Counts[i].second == Count && Counts[i].first > symbol))
+			{
+				symbol = Counts[i].first;
+				Count = Counts[i].second;
+			}
+		}
+
+		return symbol;
+	}
+
+	void Increment(Followers &Counts, byte Symbol)
+	{
+		for (size_t i = 0; i < Counts.size(); ++i)
+		{
+			if (Counts[i].first == Symbol)
+			{
+				++Counts[i].second;
+				return;
+			}
+		}
+
+		Counts.push_back(std::make_pair(Symbol, 1U));
+	}
+
+	//~~~Estimators~~~//
+
+	double MostCommonValue(const std::vector<byte> &Symbols)
+	{
+		std::vector<size_t> counts(256, 0);
+
+		for (size_t i = 0; i < Symbols.size(); ++i)
+			++counts[Symbols[i]];
+
+		const double PMAX = static_cast<double>(*std::max_element(counts.begin(), counts.end())) / Symbols.size();
+
+		return MinEntropy(UpperBound(PMAX, Symbols.size()));
+	}
+
+	double Collision(const std::vector<byte> &Bits)
+	{
+		// for binary samples the mean collision time is 2 + 2p(1 - p), so the binary search of the standard reduces to the root of a quadratic
+		double count = 0.0;
+		double sum = 0.0;
+		double sumSqr = 0.0;
+		size_t i = 0;
+
+		while (i + 1 < Bits.size())
+		{
+			size_t length = 2;
+
+			if (Bits[i] != Bits[i + 1])
+			{
+				if (i + 2 >= Bits.size())
+					break;
+
+				length = 3;
+			}
+
+			count += 1.0;
+			sum += static_cast<double>(length);
+			sumSqr += static_cast<double>(length * length);
+			i += length;
+		}
+
+		if (count < 2.0)
+			return NOT_APPLICABLE;
+
+		const double MEAN = sum / count;
+		const double DEV = std::sqrt((std::max)(0.0, (sumSqr - count * MEAN * MEAN) / (count - 1.0)));
+		const double MEANLOW = MEAN - NORMAL_Z99 * DEV / std::sqrt(count);
+
+		if (MEANLOW >= 2.5)
+			return 1.0;
+
+		if (MEANLOW <= 2.0)
+			return 0.0;
+
+		return MinEntropy((1.0 + std::sqrt(1.0 - 2.0 * (MEANLOW - 2.0))) / 2.0);
+	}
+
+	double Markov(const std::vector<byte> &Bits)
+	{
+		const size_t SEQLEN = 128;
+		double counts[4] = { 0.0, 0.0, 0.0, 0.0 };
+		double ones = 0.0;
+
+		for (size_t i = 0; i < Bits.size(); ++i)
+		{
+			ones += Bits[i];
+
+			if (i != 0)
+				counts[(Bits[i - 1] << 1) | Bits[i]] += 1.0;
+		}
+
+		auto log2p = [](double Num, double Den) { return (Num > 0.0 && Den > 0.0) ? std::log2(Num / Den) : -std::numeric_limits<double>::infinity(); };
+		const double LP0 = log2p(Bits.size() - ones, static_cast<double>(Bits.size()));
+		const double LP1 = log2p(ones, static_cast<double>(Bits.size()));
+		const double LP00 = log2p(counts[0], counts[0] + counts[1]);
+		const double LP01 = log2p(counts[1], counts[0] + counts[1]);
+		const double LP10 = log2p(counts[2], counts[2] + counts[3]);
+		const double LP11 = log2p(counts[3], counts[2] + counts[3]);
+		const double HALF = SEQLEN / 2.0;
+
+		double lmax = LP0 + (SEQLEN - 1.0) * LP00;
+		lmax = (std::max)(lmax, LP0 + HALF * LP01 + (HALF - 1.0) * LP10);
+		lmax = (std::max)(lmax, LP0 + LP01 + (SEQLEN - 2.0) * LP11);
+		lmax = (std::max)(lmax, LP1 + LP10 + (SEQLEN - 2.0) * LP00);
+		lmax = (std::max)(lmax, LP1 + HALF * LP10 + (HALF - 1.0) * LP01);
+		lmax = (std::max)(lmax, LP1 + (SEQLEN - 1.0) * LP11);
+
+		return (std::max)(0.0, (std::min)(1.0, -lmax / SEQLEN));
+	}
+
+	double Compression(const std::vector<byte> &Bits)
+	{
+		// six bit blocks, a dictionary of the first 1000 blocks, then the log distance to the previous occurrence of each block
+		const size_t BLKBTS = 6;
+		const size_t DCTLEN = 1000;
+		const size_t BLKCNT = Bits.size() / BLKBTS;
+
+		if (BLKCNT <= DCTLEN + 1)
+			return NOT_APPLICABLE;
+
+		const size_t TSTCNT = BLKCNT - DCTLEN;
+		std::vector<size_t> lastSeen(static_cast<size_t>(1) << BLKBTS, 0);
+		double sum = 0.0;
+		double sumSqr = 0.0;
+
+		for (size_t i = 1; i <= BLKCNT; ++i)
+		{
+			size_t block = 0;
+
+			for (size_t j = 0; j < BLKBTS; ++j)
+				block = (block << 1) | Bits[(i - 1) * BLKBTS + j];
+
+			if (i > DCTLEN)
+			{
+				const double DIST = std::log2(static_cast<double>((lastSeen[block] != 0) ? i - lastSeen[block] : i));
+				sum += DIST;
+				sumSqr += DIST * DIST;
+			}
+
+			lastSeen[block] = i;
+		}
+
+		const double MEAN = sum / TSTCNT;
+		const double DEV = 0.5907 * std::sqrt((std::max)(0.0, sumSqr / (TSTCNT - 1) - MEAN * MEAN));
+		const double MEANLOW = MEAN - NORMAL_Z99 * DEV / std::sqrt(static_cast<double>(TSTCNT));
+
+		// G(z); the double sum of the standard is regrouped by distance u, which makes one evaluation linear in the block count,
+		// and the z independent weight of each distance is tabled once for the bisection
+		std::vector<double> weightSqr(BLKCNT + 1, 0.0);
+		std::vector<double> weight(BLKCNT + 1, 0.0);
+
+		for (size_t u = 2; u <= BLKCNT; ++u)
+		{
+			const double LGU = std::log2(static_cast<double>(u));
+			weightSqr[u] = LGU * static_cast<double>((u < BLKCNT) ? BLKCNT - (std::max)(u, DCTLEN) : 0);
+			weight[u] = (u > DCTLEN) ? LGU : 0.0;
+		}
+
+		auto g = [&](double Z) -> double
+		{
+			if (Z <= 0.0)
+				return 0.0;
+
+			double total = 0.0;
+			double power = 1.0;
+
+			for (size_t u = 1; u <= BLKCNT && power > 1e-300; ++u)
+			{
+				total += (Z * weightSqr[u] + weight[u]) * power;
+				power *= 1.0 - Z;
+			}
+
+			return Z * total / TSTCNT;
+		};
+
+		const double SYMCNT = static_cast<double>(static_cast<size_t>(1) << BLKBTS);
+		auto expected = [&](double P) { return g(P) + (SYMCNT - 1.0) * g((1.0 - P) / (SYMCNT - 1.0)); };
+		double low = 1.0 / SYMCNT;
+		double high = 1.0;
+
+		if (MEANLOW >= expected(low))
+			return 1.0;
+
+		for (size_t i = 0; i < 48; ++i)
+		{
+			const double MID = (low + high) / 2.0;
+
+			if (expected(MID) > MEANLOW)
+				low = MID;
+			else
+				high = MID;
+		}
+
+		return MinEntropy((low + high) / 2.0) / BLKBTS;
+	}
+
+	void SuffixArray(const std::vector<byte> &Symbols, std::vector<int32_t> &Suffixes, std::vector<int32_t> &Common)
+	{
+		// prefix doubling, then Kasai's longest common prefix of each suffix with its predecessor
+		const int32_t LEN = static_cast<int32_t>(Symbols.size());
+		std::vector<int32_t> rank(LEN);
+		std::vector<int32_t> next(LEN);
+
+		Suffixes.resize(LEN);
+
+		for (int32_t i = 0; i < LEN; ++i)
+		{
+			Suffixes[i] = i;
+			rank[i] = Symbols[i];
+		}
+
+		for (int32_t k = 1; ; k <<= 1)
+		{
+			auto less = [&](int32_t A, int32_t B)
+			{
+				if (rank[A] != rank[B])
+					return rank[A] < rank[B];
+
+				const int32_t RNKA = (A + k < LEN) ? rank[A + k] : -1;
+				const int32_t RNKB = (B + k < LEN) ? rank[B + k] : -1;
+
+				return RNKA < RNKB;
+			};
+
+			std::sort(Suffixes.begin(), Suffixes.end(), less);
+			next[Suffixes[0]] = 0;
+
+			for (int32_t i = 1; i < LEN; ++i)
+				next[Suffixes[i]] = next[Suffixes[i - 1]] + (less(Suffixes[i - 1], Suffixes[i]) ? 1 : 0);
+
+			rank.swap(next);
+
+			if (rank[Suffixes[LEN - 1]] == LEN - 1)
+				break;
+		}
+
+		Common.assign(LEN, 0);
+		int32_t match = 0;
+
+		for (int32_t i = 0; i < LEN; ++i)
+		{
+			if (rank[i] == 0)
+			{
+				match = 0;
+				continue;
+			}
+
+			const int32_t PREV = Suffixes[rank[i] - 1];
+
+			while (i + match < LEN && PREV + match < LEN && Symbols[i + match] == Symbols[PREV + match])
+				++match;
+
+			Common[rank[i]] = match;
+
+			if (match > 0)
+				--match;
+		}
+	}
+
+	void TupleEstimates(const std::vector<byte> &Symbols, double &Tuple, double &Repeat)
+	{
+		// the t-tuple and LRS estimates from one suffix array; consecutive suffixes sharing a prefix of length t are the occurrences of that t-tuple
+		const size_t LEN = Symbols.size();
+		const size_t CUTOFF = 35;
+		std::vector<int32_t> suffixes;
+		std::vector<int32_t> common;
+
+		SuffixArray(Symbols, suffixes, common);
+
+		const size_t MAXCMN = static_cast<size_t>(*std::max_element(common.begin(), common.end()));
+
+		// one pass over the lcp intervals with a stack of (lcp, left bound); an interval of s suffixes with lcp L inside a parent with lcp P
+		// is a maximal run of s occurrences for every length in (P, L]. The largest run per length is a suffix maximum over L,
+		// the pairs per length a difference array over (P, L], so a long repeat costs one stack entry instead of a scan per length
+		std::vector<size_t> maxRuns(MAXCMN + 2, 1);
+		std::vector<uint64_t> pairs(MAXCMN + 2, 0);
+		std::vector<std::pair<size_t, size_t>> stack(1, std::make_pair(static_cast<size_t>(0), static_cast<size_t>(0)));
+
+		for (size_t i = 1; i <= LEN; ++i)
+		{
+			const size_t LCP = (i < LEN) ? static_cast<size_t>(common[i]) : 0;
+			size_t left = i - 1;
+
+			while (LCP < stack.back().first)
+			{
+				const size_t INTLCP = stack.back().first;
+				left = stack.back().second;
+				stack.pop_back();
+
+				const size_t PARLCP = (std::max)(LCP, stack.back().first);
+				const uint64_t RUN = static_cast<uint64_t>(i - left);
+				const uint64_t RUNPRS = RUN * (RUN - 1) / 2;
+
+				maxRuns[INTLCP] = (std::max)(maxRuns[INTLCP], static_cast<size_t>(RUN));
+				// unsigned wrap-around cancels in the prefix sum
+				pairs[PARLCP + 1] += RUNPRS;
+				pairs[INTLCP + 1] -= RUNPRS;
+			}
+
+			if (LCP > stack.back().first)
+				stack.push_back(std::make_pair(LCP, left));
+		}
+
+		for (size_t t = MAXCMN; t > 1; --t)
+			maxRuns[t - 1] = (std::max)(maxRuns[t - 1], maxRuns[t]);
+
+		for (size_t t = 1; t <= MAXCMN; ++t)
+			pairs[t] += pairs[t - 1];
+
+		double pmax = 0.0;
+		size_t tplLen = 0;
+
+		for (size_t t = 1; t <= MAXCMN; ++t)
+		{
+			if (maxRuns[t] < CUTOFF)
+				break;
+
+			tplLen = t;
+			pmax = (std::max)(pmax, std::pow(static_cast<double>(maxRuns[t]) / (LEN - t + 1), 1.0 / t));
+		}
+
+		Tuple = (tplLen == 0) ? NOT_APPLICABLE : MinEntropy(UpperBound(pmax, LEN));
+
+		// LRS runs from the first tuple length under the cutoff to the longest repeat
+		pmax = 0.0;
+
+		for (size_t w = tplLen + 1; w <= MAXCMN; ++w)
+		{
+			const double TPLCNT = static_cast<double>(LEN - w + 1);
+			pmax = (std::max)(pmax, std::pow(static_cast<double>(pairs[w]) / (TPLCNT * (TPLCNT - 1.0) / 2.0), 1.0 / w));
+		}
+
+		Repeat = (tplLen + 1 > MAXCMN) ? NOT_APPLICABLE : MinEntropy(UpperBound(pmax, LEN));
+	}
+
+	double MultiMcwPrediction(const std::vector<byte> &Symbols, size_t Alphabet)
+	{
+		const size_t WINDOWS[4] = { 63, 255, 1023, 4095 };
+		const size_t LEN = Symbols.size();
+
+		if (LEN <= WINDOWS[0] + 1)
+			return NOT_APPLICABLE;
+
+		// each window keeps symbol counts, the last position of each symbol, and its mode; ties go to the most recent symbol
+		std::vector<std::vector<uint32_t>> counts(4, std::vector<uint32_t>(256, 0));
+		std::vector<std::vector<size_t>> lastPos(4, std::vector<size_t>(256, 0));
+		int modes[4] = { -1, -1, -1, -1 };
+		Scoreboard board(4);
+
+		for (size_t i = 1; i < LEN; ++i)
+		{
+			const byte ADDSYM = Symbols[i - 1];
+
+			for (size_t j = 0; j < 4; ++j)
+			{
+				std::vector<uint32_t> &cnt = counts[j];
+				std::vector<size_t> &pos = lastPos[j];
+
+				++cnt[ADDSYM];
+				pos[ADDSYM] = i;
+
+				if (i > WINDOWS[j])
+				{
+					const byte REMSYM = Symbols[i - 1 - WINDOWS[j]];
+					--cnt[REMSYM];
+
+					if (REMSYM == modes[j] && REMSYM != ADDSYM)
+					{
+						int mode = -1;
+
+						for (size_t s = 0; s < Alphabet; ++s)
+						{
+							if (cnt[s] != 0 && (mode < 0 || cnt[s] > cnt[mode] || (cnt[s] == cnt[mode] && pos[s] > pos[mode])))
+								mode = static_cast<int>(s);
+						}
+
+						modes[j] = mode;
+						continue;
+					}
+				}
+
+				if (modes[j] < 0 || cnt[ADDSYM] >= cnt[modes[j]])
+					modes[j] = ADDSYM;
+			}
+
+			if (i < WINDOWS[0])
+				continue;
+
+			int predictions[4];
+
+			for (size_t j = 0; j < 4; ++j)
+				predictions[j] = (i >= WINDOWS[j]) ? modes[j] : -1;
+
+			board.Update(predictions, Symbols[i]);
+		}
+
+		return PredictionEntropy(board.Correct, LEN - WINDOWS[0], board.LongestRun, Alphabet);
+	}
+
+	double LagPrediction(const std::vector<byte> &Symbols, size_t Alphabet)
+	{
+		const size_t LAGS = 128;
+		const size_t LEN = Symbols.size();
+		Scoreboard board(LAGS);
+		int predictions[LAGS];
+
+		for (size_t i = 1; i < LEN; ++i)
+		{
+			for (size_t d = 0; d < LAGS; ++d)
+				predictions[d] = (i >= d + 1) ? Symbols[i - d - 1] : -1;
+
+			board.Update(predictions, Symbols[i]);
+		}
+
+		return PredictionEntropy(board.Correct, LEN - 1, board.LongestRun, Alphabet);
+	}
+
+	double MultiMmcPrediction(const std::vector<byte> &Symbols, size_t Alphabet)
+	{
+		const size_t ORDERS = 16;
+		const size_t MAXENT = 100000;
+		const size_t LEN = Symbols.size();
+
+		if (LEN < 3)
+			return NOT_APPLICABLE;
+
+		std::vector<ContextMap> models(ORDERS);
+		std::vector<size_t> entries(ORDERS, 0);
+		Scoreboard board(ORDERS);
+		History before;
+		History current;
+		int predictions[ORDERS];
+
+		current.Push(Symbols[0]);
+
+		for (size_t i = 1; i < LEN; ++i)
+		{
+			// current ends at symbol i - 1, before at symbol i - 2; model d learns that its context before i - 1 is followed by symbol i - 1
+			if (i >= 2)
+			{
+				for (size_t d = 1; d <= ORDERS && d + 1 <= i; ++d)
+				{
+					// once a model holds MAXENT transitions it only counts the transitions it already has
+					const Context KEY = before.Tail(d);
+					ContextMap::iterator itr = models[d - 1].find(KEY);
+
+					if (itr == models[d - 1].end())
+					{
+						if (entries[d - 1] < MAXENT)
+						{
+							models[d - 1].insert(std::make_pair(KEY, Followers(1, std::make_pair(Symbols[i - 1], 1U))));
+							++entries[d - 1];
+						}
+					}
+					else if (entries[d - 1] < MAXENT)
+					{
+						const size_t FOLCNT = itr->second.size();
+						Increment(itr->second, Symbols[i - 1]);
+						entries[d - 1] += itr->second.size() - FOLCNT;
+					}
+					else
+					{
+						for (size_t j = 0; j < itr->second.size(); ++j)
+						{
+							if (itr->second[j].first == Symbols[i - 1])
+								++itr->second[j].second;
+						}
+					}
+				}
+
+				for (size_t d = 1; d <= ORDERS; ++d)
+				{
+					predictions[d - 1] = -1;
+
+					if (d <= i)
+					{
+						ContextMap::const_iterator itr = models[d - 1].find(current.Tail(d));
+						uint32_t count = 0;
+
+						if (itr != models[d - 1].end())
+							predictions[d - 1] = MostFrequent(itr->second, count);
+					}
+				}
+
+				board.Update(predictions, Symbols[i]);
+			}
+
+			before = current;
+			current.Push(Symbols[i]);
+		}
+
+		return PredictionEntropy(board.Correct, LEN - 2, board.LongestRun, Alphabet);
+	}
+
+	double Lz78yPrediction(const std::vector<byte> &Symbols, size_t Alphabet)
+	{
+		const size_t MAXLEN = 16;
+		const size_t MAXDCT = 65536;
+		const size_t LEN = Symbols.size();
+
+		if (LEN <= MAXLEN + 2)
+			return NOT_APPLICABLE;
+
+		std::vector<ContextMap> dictionary(MAXLEN);
+		size_t dctSize = 0;
+		size_t correct = 0;
+		size_t run = 0;
+		size_t longest = 0;
+		History before;
+		History current;
+
+		for (size_t i = 0; i < MAXLEN + 1; ++i)
+		{
+			before = current;
+			current.Push(Symbols[i]);
+		}
+
+		for (size_t i = MAXLEN + 1; i < LEN; ++i)
+		{
+			for (size_t j = MAXLEN; j >= 1; --j)
+			{
+				const Context KEY = before.Tail(j);
+				ContextMap::iterator itr = dictionary[j - 1].find(KEY);
+
+				if (itr == dictionary[j - 1].end() && dctSize < MAXDCT)
+				{
+					itr = dictionary[j - 1].insert(std::make_pair(KEY, Followers())).first;
+					++dctSize;
+				}
+
+				if (itr != dictionary[j - 1].end())
+					Increment(itr->second, Symbols[i - 1]);
+			}
+
+			int prediction = -1;
+			uint32_t maxCount = 0;
+
+			for (size_t j = MAXLEN; j >= 1; --j)
+			{
+				ContextMap::const_iterator itr = dictionary[j - 1].find(current.Tail(j));
+
+				if (itr != dictionary[j - 1].end())
+				{
+					uint32_t count = 0;
+					const int SYMBOL = MostFrequent(itr->second, count);
+
+					if (count > maxCount)
+					{
+						prediction = SYMBOL;
+						maxCount = count;
+					}
+				}
+			}
+
+			if (prediction == Symbols[i])
+			{
+				++correct;
+				longest = (std::max)(longest, ++run);
+			}
+			else
+			{
+				run = 0;
+			}
+
+			before = current;
+			current.Push(Symbols[i]);
+		}
+
+		return PredictionEntropy(correct, LEN - MAXLEN - 1, longest, Alphabet);
+	}
+
+	void AssessChunk(const std::vector<byte> &Symbols, size_t Bits, double* Results)
+	{
+		const size_t ALPHABET = static_cast<size_t>(1) << Bits;
+
+		Results[MostCommon] = MostCommonValue(Symbols);
+		TupleEstimates(Symbols, Results[TTuple], Results[LongestRepeat]);
+		Results[MultiMcw] = MultiMcwPrediction(Symbols, ALPHABET);
+		Results[Lag] = LagPrediction(Symbols, ALPHABET);
+		Results[MultiMmc] = MultiMmcPrediction(Symbols, ALPHABET);
+		Results[Lz78y] = Lz78yPrediction(Symbols, ALPHABET);
+
+		// the binary only estimators run on the bitstring of the chunk
+		std::vector<byte> bits;
+
+		if (Bits == 1)
+			bits = Symbols;
+		else
+			ToBits(Symbols, Bits, bits);
+
+		Results[BitMostCommon] = MostCommonValue(bits);
+		Results[BitCollision] = Collision(bits);
+		Results[BitMarkov] = Markov(bits);
+		Results[BitCompression] = Compression(bits);
+	}
+
+	//~~~Permutation Test~~~//
+
+	void TestStatistics(const std::vector<byte> &Symbols, double Median, double Mean, double* Output)
+	{
+		const size_t LEN = Symbols.size();
+
+		// excursion
+		double sum = 0.0;
+		double excursion = 0.0;
+
+		for (size_t i = 0; i < LEN; ++i)
+		{
+			sum += Symbols[i];
+			excursion = (std::max)(excursion, std::fabs(sum - (i + 1) * Mean));
+		}
+
+		Output[Excursion] = excursion;
+
+		// directional runs over the signs of the successive differences
+		size_t runs = 0;
+		size_t runLen = 0;
+		size_t maxRun = 0;
+		size_t increases = 0;
+		int lastSign = 0;
+
+		for (size_t i = 0; i + 1 < LEN; ++i)
+		{
+			const int SIGN = (Symbols[i] <= Symbols[i + 1]) ? 1 : -1;
+
+			increases += (SIGN > 0) ? 1 : 0;
+			runLen = (SIGN == lastSign) ? runLen + 1 : 1;
+			runs += (SIGN == lastSign) ? 0 : 1;
+			maxRun = (std::max)(maxRun, runLen);
+			lastSign = SIGN;
+		}
+
+		Output[DirectionalRuns] = static_cast<double>(runs);
+		Output[DirectionalRunLength] = static_cast<double>(maxRun);
+		Output[IncreasesDecreases] = static_cast<double>((std::max)(increases, (LEN - 1) - increases));
+
+		// runs above and below the median
+		runs = 0;
+		runLen = 0;
+		maxRun = 0;
+		lastSign = 0;
+
+		for (size_t i = 0; i < LEN; ++i)
+		{
+			const int SIGN = (Symbols[i] < Median) ? -1 : 1;
+
+			runLen = (SIGN == lastSign) ? runLen + 1 : 1;
+			runs += (SIGN == lastSign) ? 0 : 1;
+			maxRun = (std::max)(maxRun, runLen);
+			lastSign = SIGN;
+		}
+
+		Output[MedianRuns] = static_cast<double>(runs);
+		Output[MedianRunLength] = static_cast<double>(maxRun);
+
+		// collision lengths; each run ends at the first value seen earlier in the same run
+		uint32_t seen[256] = { 0 };
+		uint32_t epoch = 1;
+		size_t start = 0;
+		size_t colCount = 0;
+		size_t colSum = 0;
+		size_t colMax = 0;
+
+		for (size_t i = 0; i < LEN; ++i)
+		{
+			if (seen[Symbols[i]] == epoch)
+			{
+				const size_t COLLEN = i - start + 1;
+				++colCount;
+				colSum += COLLEN;
+				colMax = (std::max)(colMax, COLLEN);
+				start = i + 1;
+				++epoch;
+			}
+			else
+			{
+				seen[Symbols[i]] = epoch;
+			}
+		}
+
+		Output[AverageCollision] = (colCount == 0) ? 0.0 : static_cast<double>(colSum) / colCount;
+		Output[MaximumCollision] = static_cast<double>(colMax);
+
+		for (size_t j = 0; j < 5; ++j)
+		{
+			const size_t LAG = STATISTIC_LAGS[j];
+			size_t matches = 0;
+			double product = 0.0;
+
+			for (size_t i = 0; i + LAG < LEN; ++i)
+			{
+				matches += (Symbols[i] == Symbols[i + LAG]) ? 1 : 0;
+				product += static_cast<double>(Symbols[i]) * Symbols[i + LAG];
+			}
+
+			Output[Periodicity1 + j] = static_cast<double>(matches);
+			Output[Covariance1 + j] = product;
+		}
+	}
+
+	void PermutationTest(const std::vector<byte> &Symbols, size_t Permutations, size_t Threads, std::vector<size_t> &Greater, std::vector<size_t> &Equal)
+	{
+		std::vector<byte> sorted(Symbols);
+		std::sort(sorted.begin(), sorted.end());
+
+		const size_t LEN = Symbols.size();
+		const double MEDIAN = (LEN % 2 == 1) ? sorted[LEN / 2] : (sorted[LEN / 2 - 1] + sorted[LEN / 2]) / 2.0;
+		double mean = 0.0;
+
+		for (size_t i = 0; i < LEN; ++i)
+			mean += Symbols[i];
+
+		mean /= LEN;
+
+		double original[StatisticCount];
+		TestStatistics(Symbols, MEDIAN, mean, original);
+
+		std::vector<std::vector<size_t>> greater(Threads, std::vector<size_t>(StatisticCount, 0));
+		std::vector<std::vector<size_t>> equal(Threads, std::vector<size_t>(StatisticCount, 0));
+		std::vector<std::thread> workers;
+		std::vector<std::exception_ptr> errors(Threads);
+		std::atomic<size_t> next(0);
+
+		for (size_t t = 0; t < Threads; ++t)
+		{
+			workers.push_back(std::thread([&, t]()
+			{
+				try
+				{
+					// every shuffle of the previous permutation is again a uniform permutation of the data
+					std::mt19937_64 rng(0x9E3779B97F4A7C15ULL * (t + 1));
+					std::vector<byte> shuffled(Symbols);
+					double stats[StatisticCount];
+
+					while (next.fetch_add(1) < Permutations)
+					{
+						std::shuffle(shuffled.begin(), shuffled.end(), rng);
+						TestStatistics(shuffled, MEDIAN, mean, stats);
+
+						for (size_t i = 0; i < StatisticCount; ++i)
+						{
+							greater[t][i] += (stats[i] > original[i]) ? 1 : 0;
+							equal[t][i] += (stats[i] == original[i]) ? 1 : 0;
+						}
+					}
+				}
+				catch (...)
+				{
+					// each worker copies the chunk; a failed copy must end the test, not the process
+					next.store(Permutations);
+					errors[t] = std::current_exception();
+				}
+			}));
+		}
+
+		for (size_t t = 0; t < workers.size(); ++t)
+			workers[t].join();
+
+		for (size_t t = 0; t < errors.size(); ++t)
+		{
+			if (errors[t])
+				std::rethrow_exception(errors[t]);
+		}
+
+		Greater.assign(StatisticCount, 0);
+		Equal.assign(StatisticCount, 0);
+
+		for (size_t t = 0; t < Threads; ++t)
+		{
+			for (size_t i = 0; i < StatisticCount; ++i)
+			{
+				Greater[i] += greater[t][i];
+				Equal[i] += equal[t][i];
+			}
+		}
+	}
+
+	//~~~Report~~~//
+
+	double Seconds(std::chrono::steady_clock::time_point Start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	}
+
+	void PrintEstimate(const std::string &Name, const std::vector<double> &Values, double Scale)
+	{
+		double minimum = std::numeric_limits<double>::infinity();
+		double sum = 0.0;
+		size_t count = 0;
+
+		for (size_t i = 0; i < Values.size(); ++i)
+		{
+			if (!std::isnan(Values[i]))
+			{
+				minimum = (std::min)(minimum, Values[i] * Scale);
+				sum += Values[i] * Scale;
+				++count;
+			}
+		}
+
+		std::cout << std::left << std::setw(40) << Name << std::right;
+
+		if (count == 0)
+			std::cout << std::setw(12) << "n/a" << std::setw(12) << "n/a" << std::endl;
+		else
+			std::cout << std::fixed << std::setprecision(4) << std::setw(12) << minimum << std::setw(12) << (sum / count) << std::endl;
+	}
+
+	void PrintUsage()
+	{
+		std::cout << "Usage: Assessment <file> [-b bits] [-c chunk symbols] [-n max chunks] [-p permutations] [-t threads]" << std::endl;
+		std::cout << "  file   a NoiseCapture file, or any other file as raw CJP output" << std::endl;
+		std::cout << "  -b     bits per symbol, 1 to 8; deltas are folded to this width, raw bytes are split into bits (1) or masked; default 8" << std::endl;
+		std::cout << "  -c     symbols per assessed chunk, 1000 to " << CHUNK_MAXIMUM << "; default " << CHUNK_SAMPLES << std::endl;
+		std::cout << "  -n     assess at most this many chunks; default all" << std::endl;
+		std::cout << "  -p     permutations of the IID permutation test on the first chunk, 0 to skip; default " << PERMUTATION_COUNT << std::endl;
+		std::cout << "  -t     worker threads; default one per logical processor" << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace CpuJitter;
+
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	Source input;
+	size_t chunkLen = CHUNK_SAMPLES;
+	size_t maxChunks = 0;
+	size_t permutations = PERMUTATION_COUNT;
+	size_t threads = (std::max)(1U, std::thread::hardware_concurrency());
+
+	input.Bits = 8;
+
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		const std::string OPTION(argv[i]);
+		const size_t VALUE = static_cast<size_t>(std::strtoull(argv[i + 1], 0, 10));
+
+		if (OPTION == "-b" && VALUE >= 1 && VALUE <= 8)
+			input.Bits = VALUE;
+		else if (OPTION == "-c" && VALUE >= 1000 && VALUE <= CHUNK_MAXIMUM)
+			chunkLen = VALUE;
+		else if (OPTION == "-n")
+			maxChunks = VALUE;
+		else if (OPTION == "-p")
+			permutations = VALUE;
+		else if (OPTION == "-t" && VALUE >= 1)
+			threads = VALUE;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	const std::string PATH(argv[1]);
+
+	try
+	{
+		input.Capture.Open(PATH);
+		input.IsCapture = true;
+		input.Symbols = input.Capture.Samples();
+	}
+	catch (CryptoRandomException&)
+	{
+		input.IsCapture = false;
+	}
+
+	if (!input.IsCapture)
+	{
+		try
+		{
+			input.Raw.Open(PATH);
+		}
+		catch (CryptoRandomException &ex)
+		{
+			std::cout << ex.Message() << " " << ex.Details() << std::endl;
+			return 1;
+		}
+
+		input.Symbols = (input.Bits == 1) ? static_cast<uint64_t>(input.Raw.Size()) * 8 : input.Raw.Size();
+	}
+
+	size_t chunkCount = static_cast<size_t>(input.Symbols / chunkLen);
+
+	if (maxChunks != 0)
+		chunkCount = (std::min)(chunkCount, maxChunks);
+
+	if (chunkCount == 0)
+	{
+		std::cout << "The file holds fewer than one chunk of " << chunkLen << " symbols" << std::endl;
+		return 1;
+	}
+
+	// the permutation test uses every thread, the estimators at most one per chunk
+	if (permutations == 0)
+		threads = (std::min)(threads, chunkCount);
+
+	std::cout << "*** SP 800-90B assessment: " << PATH << " ***" << std::endl;
+
+	if (input.IsCapture)
+	{
+		const CaptureHeader HEADER = input.Capture.Header();
+		std::cout << "Noise capture of " << input.Symbols << " measurements, " << input.Bits << " bit folds; " << std::string(HEADER.Vendor, strnlen(HEADER.Vendor, sizeof(HEADER.Vendor)))
+			<< ", timer source " << HEADER.TimerSource << ", memory target " << HEADER.MemoryTarget << (HEADER.EnableAccess ? "" : " (disabled)") << std::endl;
+	}
+	else
+	{
+		std::cout << "Raw output of " << input.Raw.Size() << " bytes, " << input.Bits << " bit symbols" << std::endl;
+	}
+
+	std::cout << chunkCount << " chunks of " << chunkLen << " symbols on " << threads << " threads" << std::endl << std::endl;
+
+	// every chunk is decoded and assessed by one worker; the results are kept per chunk
+	const auto ESTSTR = std::chrono::steady_clock::now();
+	std::vector<std::vector<double>> results(EstimatorCount, std::vector<double>(chunkCount, NOT_APPLICABLE));
+	std::vector<byte> firstChunk;
+	std::atomic<size_t> nextChunk(0);
+	std::vector<std::thread> workers;
+	std::vector<std::exception_ptr> errors(threads);
+
+	for (size_t t = 0; t < threads; ++t)
+	{
+		workers.push_back(std::thread([&, t]()
+		{
+			try
+			{
+				std::vector<byte> symbols;
+				double chunkResults[EstimatorCount];
+				size_t chunk = 0;
+
+				while ((chunk = nextChunk.fetch_add(1)) < chunkCount)
+				{
+					LoadChunk(input, static_cast<uint64_t>(chunk) * chunkLen, chunkLen, symbols);
+
+					if (chunk == 0)
+						firstChunk = symbols;
+
+					AssessChunk(symbols, input.Bits, chunkResults);
+
+					for (size_t i = 0; i < EstimatorCount; ++i)
+						results[i][chunk] = chunkResults[i];
+				}
+			}
+			catch (...)
+			{
+				errors[t] = std::current_exception();
+			}
+		}));
+	}
+
+	for (size_t t = 0; t < workers.size(); ++t)
+		workers[t].join();
+
+	for (size_t t = 0; t < errors.size(); ++t)
+	{
+		if (errors[t])
+		{
+			try
+			{
+				std::rethrow_exception(errors[t]);
+			}
+			catch (CryptoRandomException &ex)
+			{
+				std::cout << ex.Message() << std::endl;
+				return 1;
+			}
+			catch (std::exception &ex)
+			{
+				// an allocation failure for a large chunk, or any other library error
+				std::cout << "The assessment failed: " << ex.what() << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	const double ESTSEC = Seconds(ESTSTR);
+
+	std::cout << std::left << std::setw(40) << "Estimator (bits per symbol)" << std::right << std::setw(12) << "minimum" << std::setw(12) << "mean" << std::endl;
+
+	for (size_t i = MostCommon; i <= Lz78y; ++i)
+		PrintEstimate(ESTIMATOR_NAMES[i], results[i], 1.0);
+
+	std::cout << std::endl << std::left << std::setw(40) << "Bitstring estimator (bits per bit)" << std::right << std::setw(12) << "minimum" << std::setw(12) << "mean" << std::endl;
+
+	for (size_t i = BitMostCommon; i <= BitCompression; ++i)
+		PrintEstimate(ESTIMATOR_NAMES[i], results[i], 1.0);
+
+	// the assessed min-entropy is the smallest estimate of any chunk, with the bitstring estimates scaled to the symbol width
+	double hmin = static_cast<double>(input.Bits);
+	size_t hminIdx = MostCommon;
+
+	for (size_t i = 0; i < EstimatorCount; ++i)
+	{
+		const double SCALE = (i >= BitMostCommon) ? static_cast<double>(input.Bits) : 1.0;
+
+		for (size_t j = 0; j < chunkCount; ++j)
+		{
+			if (!std::isnan(results[i][j]) && results[i][j] * SCALE < hmin)
+			{
+				hmin = results[i][j] * SCALE;
+				hminIdx = i;
+			}
+		}
+	}
+
+	std::cout << std::endl << "Min-entropy: " << std::fixed << std::setprecision(4) << hmin << " bits per " << input.Bits << " bit symbol, "
+		<< (hmin / input.Bits) << " per bit (" << ESTIMATOR_NAMES[hminIdx] << (hminIdx >= BitMostCommon ? ", bitstring" : "") << ")" << std::endl;
+	std::cout << "Estimators: " << std::setprecision(2) << ESTSEC << " s wall clock" << std::endl << std::endl;
+
+	if (permutations != 0)
+	{
+		const auto PRMSTR = std::chrono::steady_clock::now();
+		std::vector<size_t> greater;
+		std::vector<size_t> equal;
+
+		try
+		{
+			PermutationTest(firstChunk, permutations, threads, greater, equal);
+		}
+		catch (std::exception &ex)
+		{
+			std::cout << "The permutation test failed: " << ex.what() << std::endl;
+			return 1;
+		}
+
+		const double PRMSEC = Seconds(PRMSTR);
+		// a statistic fails when the original ranks in the outer 5 of 10000 permutations on either side, scaled to the permutation count
+		const size_t RNKCUT = (std::max)(static_cast<size_t>(1), (permutations * 5) / 10000);
+		bool iid = true;
+
+		std::cout << "IID permutation test, " << permutations << " permutations of the first chunk" << std::endl;
+
+		for (size_t i = 0; i < StatisticCount; ++i)
+		{
+			const bool FAIL = (greater[i] + equal[i] <= RNKCUT) || (greater[i] >= permutations - RNKCUT);
+			iid = iid && !FAIL;
+
+			std::cout << std::left << std::setw(40) << STATISTIC_NAMES[i] << std::right << std::setw(8) << greater[i] << std::setw(8) << equal[i] << (FAIL ? "  fail" : "  pass") << std::endl;
+		}
+
+		std::cout << "The IID assumption is " << (iid ? "not rejected" : "rejected") << "; " << std::setprecision(2) << PRMSEC << " s wall clock" << std::endl << std::endl;
+	}
+
+	return 0;
+}
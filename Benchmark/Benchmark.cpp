@@ -0,0 +1,783 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include "../CpuJitter/Config.h"
+#include "../CpuJitter/AsyncCJP.h"
+#include "../CpuJitter/CJP.h"
+#include "../CpuJitter/CpuDetect.h"
+#include "../CpuJitter/EntropyEstimator.h"
+#include "../CpuJitter/HealthTest.h"
+#include "../CpuJitter/HighResTimer.h"
+#include "../CpuJitter/PerfCounter.h"
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#elif defined(CEX_OS_LINUX)
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
+namespace
+{
+	const size_t SAMPLE_COUNT = 1000;
+	const size_t SEED_SIZE = 32;
+	const size_t WORD_COUNT = 200;
+
+	template <typename Function>
+	double NanoSecondsPerCall(Function Call, size_t Count)
+	{
+		// one untimed warm-up call to fault in caches and branch history
+		Call();
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for (size_t i = 0; i < Count; ++i)
+			Call();
+
+		auto elapsed = std::chrono::high_resolution_clock::now() - start;
+
+		return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / Count;
+	}
+
+	void PrintResult(const std::string &Name, double NanoSeconds)
+	{
+		std::cout << std::left << std::setw(36) << Name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << NanoSeconds << " ns/call" << std::endl;
+	}
+
+	void PrintUnavailable(const std::string &Name)
+	{
+		std::cout << std::left << std::setw(36) << Name << std::right << std::setw(23) << "not available" << std::endl;
+	}
+
+	struct Latency
+	{
+		double Mean;
+		double P50;
+		double P90;
+		double P99;
+	};
+
+	struct MatrixEntry
+	{
+		bool Access;
+		Latency Bytes;
+		bool Debias;
+		Latency Next;
+		uint32_t OverSample;
+		bool SecureCache;
+		CpuJitter::MemoryTargets Target;
+		Latency Word;
+	};
+
+	struct MatrixOptions
+	{
+		size_t Calls;
+		int Cpu;
+		std::string CsvPath;
+		std::string JsonPath;
+		size_t Repetitions;
+		size_t Warmup;
+	};
+
+	bool TscLatency()
+	{
+		// per call latencies are read from the cycle counter when it is invariant and its frequency is known; it is far cheaper to read than the steady clock
+		static const bool USETSC = CpuJitter::HighResTimer::TscInvariant() && CpuJitter::HighResTimer::TscFrequency() != 0.0;
+
+		return USETSC;
+	}
+
+	// the GetBytes request size of the matrix; large enough to span several generation cycles
+	const size_t MATRIX_BLOCK = 64;
+
+	template <typename Function>
+	Latency MeasureLatency(Function Call, const MatrixOptions &Options)
+	{
+		// untimed warm-up calls, then every call of every repetition is timed on its own so the tail of the distribution is kept
+		std::vector<double> samples;
+		samples.reserve(Options.Calls * Options.Repetitions);
+
+		for (size_t i = 0; i < Options.Warmup; ++i)
+			Call();
+
+		const bool USETSC = TscLatency();
+
+		for (size_t i = 0; i < Options.Repetitions; ++i)
+		{
+			for (size_t j = 0; j < Options.Calls; ++j)
+			{
+				if (USETSC)
+				{
+					const uint64_t START = CpuJitter::HighResTimer::LfenceRdtsc();
+					Call();
+					const uint64_t TICKS = CpuJitter::HighResTimer::LfenceRdtsc() - START;
+					samples.push_back(CpuJitter::HighResTimer::ToNanoseconds(TICKS, CpuJitter::TimerSources::LfenceRdtsc));
+					continue;
+				}
+
+				auto start = std::chrono::steady_clock::now();
+				Call();
+				auto elapsed = std::chrono::steady_clock::now() - start;
+				samples.push_back(static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+			}
+		}
+
+		std::sort(samples.begin(), samples.end());
+
+		auto rank = [&samples](double Fraction) { return samples[(std::min)(samples.size() - 1, static_cast<size_t>(Fraction * samples.size()))]; };
+		double sum = 0.0;
+
+		for (size_t i = 0; i < samples.size(); ++i)
+			sum += samples[i];
+
+		Latency lat = { sum / samples.size(), rank(0.5), rank(0.9), rank(0.99) };
+
+		return lat;
+	}
+
+	bool PinCurrentThread(int Cpu)
+	{
+#if defined(CEX_OS_WINDOWS)
+		return Cpu >= 0 && Cpu < static_cast<int>(sizeof(DWORD_PTR) * 8) && SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << Cpu) != 0;
+#elif defined(CEX_OS_LINUX)
+		if (Cpu < 0 || Cpu >= CPU_SETSIZE)
+			return false;
+
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(Cpu, &cpuSet);
+
+		return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+		(void)Cpu;
+		return false;
+#endif
+	}
+
+	void WriteLatencyJson(std::ostream &Output, const char* Name, const Latency &Value)
+	{
+		Output << "\"" << Name << "\": { \"meanNs\": " << Value.Mean << ", \"p50Ns\": " << Value.P50 << ", \"p90Ns\": " << Value.P90 << ", \"p99Ns\": " << Value.P99 << " }";
+	}
+
+	void WriteMatrixJson(std::ostream &Output, const std::vector<MatrixEntry> &Entries, const MatrixOptions &Options, const std::string &Vendor, const std::string &Timer, bool Pinned)
+	{
+		Output << std::fixed << std::setprecision(1);
+		Output << "{" << std::endl;
+		Output << "  \"host\": { \"vendor\": \"" << Vendor << "\", \"timer\": \"" << Timer << "\", \"cpu\": " << Options.Cpu << ", \"pinned\": " << (Pinned ? "true" : "false") << " }," << std::endl;
+		Output << "  \"settings\": { \"warmup\": " << Options.Warmup << ", \"calls\": " << Options.Calls << ", \"repetitions\": " << Options.Repetitions << ", \"getBytesSize\": " << MATRIX_BLOCK << " }," << std::endl;
+		Output << "  \"results\": [" << std::endl;
+
+		for (size_t i = 0; i < Entries.size(); ++i)
+		{
+			const MatrixEntry &ent = Entries[i];
+
+			Output << "    { \"enableAccess\": " << (ent.Access ? "true" : "false") << ", \"enableDebias\": " << (ent.Debias ? "true" : "false")
+				<< ", \"overSampleRate\": " << ent.OverSample << ", \"secureCache\": " << (ent.SecureCache ? "true" : "false")
+				<< ", \"memoryTarget\": \"" << (ent.Access ? CpuJitter::NoiseBuffer::Name(ent.Target) : "None") << "\""
+				<< ", \"bytesPerSecond\": " << (1e9 * MATRIX_BLOCK / ent.Bytes.Mean) << ", ";
+			WriteLatencyJson(Output, "getBytes", ent.Bytes);
+			Output << ", ";
+			WriteLatencyJson(Output, "next", ent.Next);
+			Output << ", ";
+			WriteLatencyJson(Output, "nextUInt64", ent.Word);
+			Output << " }" << (i + 1 < Entries.size() ? "," : "") << std::endl;
+		}
+
+		Output << "  ]" << std::endl << "}" << std::endl;
+	}
+
+	void WriteMatrixCsv(std::ostream &Output, const std::vector<MatrixEntry> &Entries)
+	{
+		Output << "enable_access,enable_debias,over_sample_rate,secure_cache,memory_target,bytes_per_second,"
+			<< "getbytes_mean_ns,getbytes_p50_ns,getbytes_p90_ns,getbytes_p99_ns,next_mean_ns,next_p50_ns,next_p90_ns,next_p99_ns,"
+			<< "nextuint64_mean_ns,nextuint64_p50_ns,nextuint64_p90_ns,nextuint64_p99_ns" << std::endl;
+		Output << std::fixed << std::setprecision(1);
+
+		for (size_t i = 0; i < Entries.size(); ++i)
+		{
+			const MatrixEntry &ent = Entries[i];
+			const Latency* LATS[] = { &ent.Bytes, &ent.Next, &ent.Word };
+
+			Output << ent.Access << "," << ent.Debias << "," << ent.OverSample << "," << ent.SecureCache << "," << (ent.Access ? CpuJitter::NoiseBuffer::Name(ent.Target) : "None")
+				<< "," << (1e9 * MATRIX_BLOCK / ent.Bytes.Mean);
+
+			for (size_t j = 0; j < 3; ++j)
+				Output << "," << LATS[j]->Mean << "," << LATS[j]->P50 << "," << LATS[j]->P90 << "," << LATS[j]->P99;
+
+			Output << std::endl;
+		}
+	}
+}
+
+void BenchmarkAllocation()
+{
+	// compares the allocating vector overloads against the allocation free pointer and integer paths;
+	// the noise sources and the secure cache round are disabled so that call overhead is not buried under jitter collection
+	CpuJitter::CJP gen;
+
+	if (!gen.IsAvailable())
+	{
+		std::cout << "CJP is not available on this system" << std::endl;
+		return;
+	}
+
+	gen.EnableAccess() = false;
+	gen.EnableDebias() = false;
+	gen.SecureCache() = false;
+
+	std::vector<byte> seed(SEED_SIZE);
+	byte raw[SEED_SIZE];
+	volatile uint64_t sink = 0;
+
+	std::cout << "*** CJP allocation overhead (" << SAMPLE_COUNT << " calls, " << SEED_SIZE << " byte requests) ***" << std::endl;
+
+	PrintResult("GetBytes(size_t) -> vector", NanoSecondsPerCall([&]() { std::vector<byte> tmp = gen.GetBytes(SEED_SIZE); sink += tmp[0]; }, SAMPLE_COUNT));
+	PrintResult("GetBytes(vector&)", NanoSecondsPerCall([&]() { gen.GetBytes(seed); sink += seed[0]; }, SAMPLE_COUNT));
+	PrintResult("GetBytes(byte*, size_t)", NanoSecondsPerCall([&]() { gen.GetBytes(raw, SEED_SIZE); sink += raw[0]; }, SAMPLE_COUNT));
+
+	// the previous Next() implementation: a four byte vector filled through the offset overload
+	PrintResult("Next() via 4 byte vector", NanoSecondsPerCall([&]()
+	{
+		std::vector<byte> tmp(sizeof(uint32_t));
+		gen.GetBytes(tmp, 0, tmp.size());
+		uint32_t rnd = 0;
+		memcpy(&rnd, &tmp[0], sizeof(uint32_t));
+		sink += rnd;
+	}, SAMPLE_COUNT));
+
+	PrintResult("NextUInt32()", NanoSecondsPerCall([&]() { sink += gen.NextUInt32(); }, SAMPLE_COUNT));
+	PrintResult("NextUInt64()", NanoSecondsPerCall([&]() { sink += gen.NextUInt64(); }, SAMPLE_COUNT));
+	std::cout << std::endl;
+}
+
+void BenchmarkConstruction()
+{
+	// the full constructor: timer selection and qualification, noise buffer allocation, and the SP 800-90B startup samples;
+	// the explicit source skips the timer ranking so the two lines separate its cost from the rest
+	const size_t CTRCNT = 20;
+	volatile uint64_t sink = 0;
+
+	std::cout << "*** CJP construction (" << CTRCNT << " instances) ***" << std::endl;
+	PrintResult("CJP(Auto)", NanoSecondsPerCall([&]() { CpuJitter::CJP gen; sink += gen.IsAvailable(); }, CTRCNT));
+	PrintResult("CJP(Default)", NanoSecondsPerCall([&]() { CpuJitter::CJP gen(CpuJitter::TimerSources::Default); sink += gen.IsAvailable(); }, CTRCNT));
+
+	// the background mode: the time until the constructor returns, and until the provider is ready
+	std::vector<std::unique_ptr<CpuJitter::AsyncCJP>> pending;
+	PrintResult("AsyncCJP(Auto) return", NanoSecondsPerCall([&]() { pending.emplace_back(new CpuJitter::AsyncCJP()); }, CTRCNT));
+	pending.clear();
+	PrintResult("AsyncCJP(Auto) to Ready", NanoSecondsPerCall([&]() { CpuJitter::AsyncCJP gen; sink += gen.Ready().get(); }, CTRCNT));
+	std::cout << std::endl;
+}
+
+template <typename Generator>
+void PrintWordCost(const std::string &Name, Generator &Gen)
+{
+	if (!Gen.IsAvailable())
+	{
+		PrintUnavailable(Name);
+		return;
+	}
+
+	volatile uint64_t sink = 0;
+	PrintResult(Name, NanoSecondsPerCall([&]() { sink += Gen.NextUInt64(); }, WORD_COUNT));
+}
+
+void BenchmarkSpecialization()
+{
+	// per-word cost of the compile-time specializations against the runtime-configurable CJP class set to the same configuration;
+	// the secure cache round is disabled on every generator so that a call measures exactly one 64bit word
+	using namespace CpuJitter;
+
+	std::cout << "*** BasicCJP specializations (" << WORD_COUNT << " words) ***" << std::endl;
+
+	{
+		CJP gen(TimerSources::Rdtsc);
+		gen.SecureCache() = false;
+		PrintWordCost("CJP rdtsc, full pipeline", gen);
+	}
+	{
+		BasicCJP<RdtscTimer, MemoryNoise, VonNeumannExtractor, StirPoolMix> gen;
+		gen.SecureCache() = false;
+		PrintWordCost("Static rdtsc, full pipeline", gen);
+	}
+	{
+		BasicCJP<LfenceRdtscTimer, MemoryNoise, VonNeumannExtractor, StirPoolMix> gen;
+		gen.SecureCache() = false;
+		PrintWordCost("Static lfence+rdtsc, full pipeline", gen);
+	}
+	{
+		BasicCJP<MonotonicTimer, MemoryNoise, VonNeumannExtractor, StirPoolMix> gen;
+		gen.SecureCache() = false;
+		PrintWordCost("Static monotonic, full pipeline", gen);
+	}
+	{
+		CJP gen(TimerSources::Rdtsc);
+		gen.EnableAccess() = false;
+		gen.SecureCache() = false;
+		PrintWordCost("CJP rdtsc, no memory noise", gen);
+	}
+	{
+		BasicCJP<RdtscTimer, NoMemoryNoise, VonNeumannExtractor, StirPoolMix> gen;
+		gen.SecureCache() = false;
+		PrintWordCost("Static rdtsc, no memory noise", gen);
+	}
+	{
+		CJP gen(TimerSources::Rdtsc);
+		gen.EnableAccess() = false;
+		gen.EnableDebias() = false;
+		gen.EnableStir() = false;
+		gen.SecureCache() = false;
+		PrintWordCost("CJP rdtsc, jitter only", gen);
+	}
+	{
+		BasicCJP<RdtscTimer, NoMemoryNoise, NoExtractor, NoMix> gen;
+		gen.SecureCache() = false;
+		PrintWordCost("Static rdtsc, jitter only", gen);
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkPerfCounters()
+{
+	// the perf_event cycle counter against the clock path: the cost of one read, the per-word cost of a provider timed by each source,
+	// and the cost of mixing the miss counts of each memory access pass; the perf lines are not available where hardware events are restricted
+	using namespace CpuJitter;
+
+	const TimerSources SOURCES[] = { TimerSources::ClockMonotonic, TimerSources::Rdtsc, TimerSources::PerfCycles };
+	const size_t SRCCNT = sizeof(SOURCES) / sizeof(SOURCES[0]);
+
+	std::cout << "*** perf_event counters (" << WORD_COUNT << " words, user space rdpmc " << (PerfCounter::Available() ? "available" : "not available") << ") ***" << std::endl;
+
+	for (size_t i = 0; i < SRCCNT; ++i)
+	{
+		const std::string NAME = std::string(HighResTimer::Name(SOURCES[i])) + " read";
+
+		if (HighResTimer::Function(SOURCES[i]) == 0)
+			PrintUnavailable(NAME);
+		else
+			PrintResult(NAME, HighResTimer::Cost(SOURCES[i]));
+	}
+
+	for (size_t i = 0; i < SRCCNT; ++i)
+	{
+		CJP gen(SOURCES[i]);
+		gen.SecureCache() = false;
+		PrintWordCost(std::string("CJP ") + HighResTimer::Name(SOURCES[i]) + ", full pipeline", gen);
+	}
+
+	if (PerfCounter::EventsAvailable())
+	{
+		CJP gen(TimerSources::ClockMonotonic);
+		gen.EnablePerfEvents() = true;
+		gen.SecureCache() = false;
+		PrintWordCost("CJP CLOCK_MONOTONIC, miss counts", gen);
+	}
+	else
+	{
+		PrintUnavailable("CJP CLOCK_MONOTONIC, miss counts");
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkExtractors()
+{
+	// extractor yield and per-word cost; the memory noise source is disabled so that a measurement costs a timer read and a fold
+	using namespace CpuJitter;
+
+	const Extractors TYPES[] = { Extractors::None, Extractors::VonNeumann, Extractors::Peres, Extractors::Elias };
+
+	std::cout << "*** Extractor efficiency (" << WORD_COUNT << " words) ***" << std::endl;
+
+	for (size_t i = 0; i < sizeof(TYPES) / sizeof(TYPES[0]); ++i)
+	{
+		CJP gen;
+
+		if (!gen.IsAvailable())
+		{
+			std::cout << "CJP is not available on this system" << std::endl;
+			return;
+		}
+
+		gen.EnableAccess() = false;
+		gen.SecureCache() = false;
+		gen.EnableDebias() = (TYPES[i] != Extractors::None);
+		gen.Extractor() = TYPES[i];
+		// clear the counters left by the constructor
+		gen.Reset();
+
+		volatile uint64_t sink = 0;
+		const double NSPW = NanoSecondsPerCall([&]() { sink += gen.NextUInt64(); }, WORD_COUNT);
+
+		std::cout << std::left << std::setw(36) << BitExtractor::Name(TYPES[i]) << std::right << std::setw(14) << std::fixed << std::setprecision(1) << NSPW << " ns/word"
+			<< std::setw(10) << std::setprecision(3) << gen.ExtractorEfficiency() << " bits/measurement" << std::endl;
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkMemoryTargets()
+{
+	// per-word cost of the memory access noise source on each memory level, with regular and transparent huge pages;
+	// the extractor is disabled so that every word takes the same number of measurements
+	using namespace CpuJitter;
+
+	const MemoryTargets TARGETS[] = { MemoryTargets::L1, MemoryTargets::L2, MemoryTargets::L3, MemoryTargets::Dram };
+	const HugePages PAGES[] = { HugePages::None, HugePages::Transparent };
+
+	std::cout << "*** Memory noise targets (" << WORD_COUNT << " words) ***" << std::endl;
+
+	for (size_t i = 0; i < sizeof(TARGETS) / sizeof(TARGETS[0]); ++i)
+	{
+		for (size_t j = 0; j < sizeof(PAGES) / sizeof(PAGES[0]); ++j)
+		{
+			CJP gen;
+
+			if (!gen.IsAvailable())
+			{
+				std::cout << "CJP is not available on this system" << std::endl;
+				return;
+			}
+
+			gen.EnableDebias() = false;
+			gen.SecureCache() = false;
+			gen.MemoryTarget() = TARGETS[i];
+			gen.MemoryPages() = PAGES[j];
+			// rebuild the noise buffer with the new settings
+			gen.Reset();
+
+			const std::string NAME = std::string(NoiseBuffer::Name(TARGETS[i])) + ((gen.MemoryBacking() == HugePages::None) ? ", regular pages" : ", huge pages");
+			PrintWordCost(NAME, gen);
+		}
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkNumaPlacement()
+{
+	// per-word cost with the noise buffer on the local node, the most distant node, and placed by the operating system;
+	// the buffer targets DRAM so that every access leaves the caches, and the benchmark thread is held on its starting node
+	using namespace CpuJitter;
+
+	const NumaPlacements PLACEMENTS[] = { NumaPlacements::Unbound, NumaPlacements::Local, NumaPlacements::Remote };
+	const char* NAMES[] = { "Unbound", "Local", "Remote" };
+	const int HOMENODE = NumaTopology::CurrentNode();
+
+	std::cout << "*** NUMA placement (" << NumaTopology::NodeCount() << " nodes, " << WORD_COUNT << " words) ***" << std::endl;
+
+	if (HOMENODE >= 0)
+		NumaTopology::BindThread(static_cast<size_t>(HOMENODE));
+
+	for (size_t i = 0; i < sizeof(PLACEMENTS) / sizeof(PLACEMENTS[0]); ++i)
+	{
+		CJP gen;
+
+		if (!gen.IsAvailable())
+		{
+			std::cout << "CJP is not available on this system" << std::endl;
+			return;
+		}
+
+		gen.EnableDebias() = false;
+		gen.SecureCache() = false;
+		gen.MemoryTarget() = MemoryTargets::Dram;
+		gen.MemoryPlacement() = PLACEMENTS[i];
+		gen.Reset();
+
+		const std::string NAME = std::string(NAMES[i]) + ((gen.MemoryNode() < 0) ? std::string(", os placed") : ", node " + std::to_string(gen.MemoryNode()));
+		PrintWordCost(NAME, gen);
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkHealthTests()
+{
+	// the cost of the continuous health tests per measurement, against the measured cost of one measurement in the jitter only path and in the default pipeline;
+	// the tests are timed over recorded timer deltas so that the timer read is not part of their cost
+	using namespace CpuJitter;
+
+	const size_t DLTCNT = 4096;
+	const size_t PASSES = 256;
+	std::vector<uint64_t> deltas(DLTCNT);
+	uint64_t prev = HighResTimer::Default();
+
+	for (size_t i = 0; i < DLTCNT; ++i)
+	{
+		const uint64_t TIME = HighResTimer::Default();
+		deltas[i] = TIME - prev;
+		prev = TIME;
+	}
+
+	HealthTest health;
+	volatile int status = 0;
+	const double SMPNS = NanoSecondsPerCall([&]()
+	{
+		for (size_t i = 0; i < DLTCNT; ++i)
+			health.Sample(deltas[i]);
+
+		status += static_cast<int>(health.Status());
+	}, PASSES) / DLTCNT;
+
+	std::cout << "*** Health test overhead (" << WORD_COUNT << " words) ***" << std::endl;
+	PrintResult("RCT + APT per sample", SMPNS);
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		CJP gen;
+
+		if (!gen.IsAvailable())
+		{
+			std::cout << "CJP is not available on this system" << std::endl;
+			return;
+		}
+
+		const bool JTRONLY = (i == 0);
+
+		gen.SecureCache() = false;
+
+		if (JTRONLY)
+		{
+			gen.EnableAccess() = false;
+			gen.EnableStir() = false;
+			gen.Extractor() = Extractors::None;
+		}
+
+		gen.Reset();
+
+		volatile uint64_t sink = 0;
+		const double WRDNS = NanoSecondsPerCall([&]() { sink += gen.NextUInt64(); }, WORD_COUNT);
+		// one priming measurement per word, then one measurement per raw bit the extractor consumes
+		const double MSRCNT = 1.0 + (64.0 / gen.ExtractorEfficiency());
+		const double MSRNS = WRDNS / MSRCNT;
+
+		std::cout << std::left << std::setw(36) << (JTRONLY ? "Jitter only, per measurement" : "Default pipeline, per measurement") << std::right << std::setw(14) << std::fixed << std::setprecision(1) << MSRNS << " ns"
+			<< std::setw(10) << std::setprecision(2) << (100.0 * SMPNS / MSRNS) << " % health test overhead" << std::endl;
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkEstimator()
+{
+	// the per measurement cost of the streaming min-entropy estimators and of a query, then the estimates and the oversampling rate they call for on this host,
+	// in the jitter only path and in the default pipeline
+	using namespace CpuJitter;
+
+	const size_t DLTCNT = EntropyEstimator::WINDOW;
+	const size_t PASSES = 256;
+	std::vector<uint64_t> deltas(DLTCNT);
+	uint64_t prev = HighResTimer::Default();
+
+	for (size_t i = 0; i < DLTCNT; ++i)
+	{
+		const uint64_t TIME = HighResTimer::Default();
+		deltas[i] = TIME - prev;
+		prev = TIME;
+	}
+
+	EntropyEstimator estimator;
+	volatile double sink = 0;
+	const double SMPNS = NanoSecondsPerCall([&]()
+	{
+		for (size_t i = 0; i < DLTCNT; ++i)
+			estimator.Sample(deltas[i]);
+	}, PASSES) / DLTCNT;
+	const double QRYNS = NanoSecondsPerCall([&]() { sink += estimator.Estimate().MinEntropy; }, PASSES);
+
+	std::cout << "*** Streaming min-entropy estimators (" << EntropyEstimator::WINDOW << " sample window) ***" << std::endl;
+	PrintResult("MCV + collision + Markov per sample", SMPNS);
+	PrintResult("Estimate query", QRYNS);
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		CJP gen;
+
+		if (!gen.IsAvailable())
+		{
+			std::cout << "CJP is not available on this system" << std::endl;
+			return;
+		}
+
+		const bool JTRONLY = (i == 0);
+
+		gen.EnableEstimator() = true;
+
+		if (JTRONLY)
+		{
+			gen.EnableAccess() = false;
+			gen.EnableStir() = false;
+			gen.Extractor() = Extractors::None;
+		}
+
+		gen.Reset();
+
+		volatile uint64_t word = 0;
+
+		while (gen.RequiredOverSampleRate() == 0)
+			word += gen.NextUInt64();
+
+		const EntropyEstimate EST = gen.Estimate();
+
+		std::cout << (JTRONLY ? "Jitter only" : "Default pipeline") << std::fixed << std::setprecision(3)
+			<< ": MCV " << EST.BitMcv << ", collision " << EST.Collision << ", Markov " << EST.Markov
+			<< " bits per folded bit; MCV " << EST.SymbolMcv << " bits per 8 bit fold; OverSampleRate " << gen.RequiredOverSampleRate() << std::endl;
+	}
+
+	std::cout << std::endl;
+}
+
+void BenchmarkMatrix(const MatrixOptions &Options)
+{
+	// GetBytes throughput and the latency distribution of GetBytes, Next and NextUInt64 over every combination of the configuration knobs;
+	// with the memory noise source disabled the buffer size has no effect, so that half of the matrix is run once. NextUInt64 is one Generate64 cycle
+	// plus the secure cache refresh when SecureCache is set
+	using namespace CpuJitter;
+
+	const MemoryTargets TARGETS[] = { MemoryTargets::L1, MemoryTargets::L2, MemoryTargets::L3, MemoryTargets::Dram };
+	const uint32_t RATES[] = { 1, 2, 4 };
+	const bool PINNED = PinCurrentThread(Options.Cpu);
+	std::string vendor;
+	std::string timer;
+	std::vector<MatrixEntry> entries;
+
+	try
+	{
+		vendor = CpuDetect::Snapshot()->VendorName();
+	}
+	catch (...)
+	{
+		vendor = "unknown";
+	}
+
+	std::cout << "*** Latency timer: " << (TscLatency() ? "invariant TSC at " : "steady clock");
+
+	if (TscLatency())
+		std::cout << std::fixed << std::setprecision(1) << (CpuJitter::HighResTimer::TscFrequency() / 1e6) << " MHz";
+
+	std::cout << " ***" << std::endl;
+	std::cout << "*** Configuration matrix (" << Options.Warmup << " warm-up, " << Options.Repetitions << " x " << Options.Calls << " calls, "
+		<< (PINNED ? "pinned to cpu " + std::to_string(Options.Cpu) : std::string("unpinned")) << ") ***" << std::endl;
+	std::cout << std::left << std::setw(36) << "Memory/Debias/Rate/Cache" << std::right << std::setw(12) << "bytes/s" << std::setw(12) << "bytes p99"
+		<< std::setw(12) << "Next ns" << std::setw(12) << "Next p99" << std::setw(12) << "word ns" << std::setw(12) << "word p99" << std::endl;
+
+	for (size_t access = 0; access < 2; ++access)
+	{
+		const size_t TGTCNT = (access != 0) ? sizeof(TARGETS) / sizeof(TARGETS[0]) : 1;
+
+		for (size_t tgt = 0; tgt < TGTCNT; ++tgt)
+		{
+			for (size_t debias = 0; debias < 2; ++debias)
+			{
+				for (size_t rate = 0; rate < sizeof(RATES) / sizeof(RATES[0]); ++rate)
+				{
+					for (size_t cache = 0; cache < 2; ++cache)
+					{
+						CJP gen;
+
+						if (!gen.IsAvailable())
+						{
+							std::cout << "CJP is not available on this system" << std::endl;
+							return;
+						}
+
+						MatrixEntry ent;
+						ent.Access = (access != 0);
+						ent.Debias = (debias != 0);
+						ent.OverSample = RATES[rate];
+						ent.SecureCache = (cache != 0);
+						ent.Target = TARGETS[tgt];
+
+						gen.EnableAccess() = ent.Access;
+						gen.EnableDebias() = ent.Debias;
+						gen.OverSampleRate() = ent.OverSample;
+						gen.SecureCache() = ent.SecureCache;
+						gen.MemoryTarget() = ent.Target;
+						// rebuild the noise buffer with the new settings
+						gen.Reset();
+						timer = HighResTimer::Name(gen.TimerSource());
+
+						byte block[MATRIX_BLOCK];
+						volatile uint64_t sink = 0;
+
+						ent.Bytes = MeasureLatency([&]() { gen.GetBytes(block, MATRIX_BLOCK); sink += block[0]; }, Options);
+						ent.Next = MeasureLatency([&]() { sink += gen.Next(); }, Options);
+						ent.Word = MeasureLatency([&]() { sink += gen.NextUInt64(); }, Options);
+						entries.push_back(ent);
+
+						const std::string NAME = std::string(ent.Access ? NoiseBuffer::Name(ent.Target) : "None") + (ent.Debias ? "/on/" : "/off/") + std::to_string(ent.OverSample) + (ent.SecureCache ? "/on" : "/off");
+
+						std::cout << std::left << std::setw(36) << NAME << std::right << std::fixed << std::setprecision(0) << std::setw(12) << (1e9 * MATRIX_BLOCK / ent.Bytes.Mean)
+							<< std::setw(12) << ent.Bytes.P99 << std::setw(12) << ent.Next.Mean << std::setw(12) << ent.Next.P99 << std::setw(12) << ent.Word.Mean << std::setw(12) << ent.Word.P99 << std::endl;
+					}
+				}
+			}
+		}
+	}
+
+	if (!Options.JsonPath.empty())
+	{
+		std::ofstream json(Options.JsonPath.c_str());
+		WriteMatrixJson(json, entries, Options, vendor, timer, PINNED);
+		std::cout << "Wrote " << Options.JsonPath << std::endl;
+	}
+
+	if (!Options.CsvPath.empty())
+	{
+		std::ofstream csv(Options.CsvPath.c_str());
+		WriteMatrixCsv(csv, entries);
+		std::cout << "Wrote " << Options.CsvPath << std::endl;
+	}
+
+	std::cout << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	// Benchmark -matrix [-calls n] [-cpu n] [-csv file] [-json file] [-reps n] [-warmup n] runs the configuration matrix alone
+	if (argc > 1 && std::string(argv[1]) == "-matrix")
+	{
+		MatrixOptions opts = { 16, 0, "", "", 3, 4 };
+
+		for (int i = 2; i + 1 < argc; i += 2)
+		{
+			const std::string OPTION(argv[i]);
+
+			if (OPTION == "-calls")
+				opts.Calls = (std::max)(1, std::atoi(argv[i + 1]));
+			else if (OPTION == "-cpu")
+				opts.Cpu = std::atoi(argv[i + 1]);
+			else if (OPTION == "-csv")
+				opts.CsvPath = argv[i + 1];
+			else if (OPTION == "-json")
+				opts.JsonPath = argv[i + 1];
+			else if (OPTION == "-reps")
+				opts.Repetitions = (std::max)(1, std::atoi(argv[i + 1]));
+			else if (OPTION == "-warmup")
+				opts.Warmup = static_cast<size_t>((std::max)(0, std::atoi(argv[i + 1])));
+		}
+
+		BenchmarkMatrix(opts);
+
+		return 0;
+	}
+
+	BenchmarkAllocation();
+	BenchmarkConstruction();
+	BenchmarkSpecialization();
+	BenchmarkPerfCounters();
+	BenchmarkExtractors();
+	BenchmarkMemoryTargets();
+	BenchmarkNumaPlacement();
+	BenchmarkHealthTests();
+	BenchmarkEstimator();
+
+	return 0;
+}
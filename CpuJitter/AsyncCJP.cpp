@@ -0,0 +1,107 @@
+#include "AsyncCJP.h"
+#include "CryptoRandomException.h"
+
+namespace CpuJitter
+{
+	CJP &AsyncCJP::Generator()
+	{
+		Wait();
+
+		if (!m_generator)
+			throw CryptoRandomException("AsyncCJP:Generator", "The provider has been destroyed!");
+
+		return *m_generator;
+	}
+
+	const bool AsyncCJP::IsAvailable()
+	{
+		if (!IsReady())
+			return false;
+
+		try
+		{
+			return Wait() && m_generator->IsAvailable();
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	void AsyncCJP::Destroy()
+	{
+		if (m_worker.joinable())
+			m_worker.join();
+
+		if (m_generator)
+		{
+			m_generator->Destroy();
+			m_generator.reset();
+		}
+	}
+
+	void AsyncCJP::GetBytes(std::vector<byte> &Output)
+	{
+		Acquire("AsyncCJP:GetBytes").GetBytes(Output);
+	}
+
+	void AsyncCJP::GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length)
+	{
+		Acquire("AsyncCJP:GetBytes").GetBytes(Output, Offset, Length);
+	}
+
+	void AsyncCJP::GetBytes(byte* Output, size_t Length)
+	{
+		Acquire("AsyncCJP:GetBytes").GetBytes(Output, Length);
+	}
+
+	std::vector<byte> AsyncCJP::GetBytes(size_t Length)
+	{
+		return Acquire("AsyncCJP:GetBytes").GetBytes(Length);
+	}
+
+	uint32_t AsyncCJP::Next()
+	{
+		return Acquire("AsyncCJP:Next").Next();
+	}
+
+	uint32_t AsyncCJP::NextUInt32()
+	{
+		return Acquire("AsyncCJP:NextUInt32").NextUInt32();
+	}
+
+	uint64_t AsyncCJP::NextUInt64()
+	{
+		return Acquire("AsyncCJP:NextUInt64").NextUInt64();
+	}
+
+	bool AsyncCJP::Wait()
+	{
+		// the value is published by the worker after it has stored the provider, so the pointer is safe to read once the future is ready
+		const bool AVLBLE = m_ready.get();
+
+		return AVLBLE && m_generator;
+	}
+
+	CJP &AsyncCJP::Acquire(const std::string &Method)
+	{
+		if (!Wait())
+			throw CryptoRandomException(Method, "High resolution timer not available or too coarse for RNG!");
+
+		return *m_generator;
+	}
+
+	void AsyncCJP::Initialize(TimerSources Timer)
+	{
+		// runs on the worker thread; a failure of the constructor is handed to whoever waits on the future
+		try
+		{
+			m_generator.reset(new CJP(Timer));
+			m_promise.set_value(m_generator->IsAvailable());
+		}
+		catch (...)
+		{
+			m_promise.set_exception(std::current_exception());
+		}
+	}
+}
@@ -0,0 +1,183 @@
+#ifndef _CEXENGINE_ASYNCCJP_H
+#define _CEXENGINE_ASYNCCJP_H
+
+#include "Config.h"
+#include "CJP.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// A CPU Jitter entropy Provider that initializes in the background.
+	/// <para>The constructor returns at once; the timer selection and qualification, the noise buffer allocation and the SP 800-90B startup samples of the CJP constructor run on a worker thread.
+	/// IsAvailable and IsReady are non-blocking readiness queries, Ready returns a future that can be waited on explicitly,
+	/// and a request for data made before initialization has finished waits for it and is then served by the provider.</para>
+	/// </summary>
+	///
+	/// <example>
+	/// <description>Example of starting a provider early and getting a seed value later:</description>
+	/// <code>
+	/// AsyncCJP gen;
+	/// // ... other startup work
+	/// std:vector&lt;uint8_t&gt; output(32);
+	/// gen.GetBytes(output);
+	/// </code>
+	/// </example>
+	class AsyncCJP
+	{
+	private:
+		std::unique_ptr<CJP> m_generator;
+		std::promise<bool> m_promise;
+		std::shared_future<bool> m_ready;
+		std::thread m_worker;
+
+	public:
+
+		AsyncCJP(const AsyncCJP&) = delete;
+		AsyncCJP& operator=(const AsyncCJP&) = delete;
+		AsyncCJP& operator=(AsyncCJP&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The initialized provider, for configuration and the properties not forwarded by this class; waits for initialization to finish
+		/// </summary>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider was destroyed; an exception thrown by the CJP constructor is rethrown</exception>
+		CJP &Generator();
+
+		/// <summary>
+		/// Get: Initialization has finished and the entropy provider is available on this system; does not wait.
+		/// <para>False while initializing, if no qualifying timer was found, or if initialization failed; Wait reports the reason.</para>
+		/// </summary>
+		const bool IsAvailable();
+
+		/// <summary>
+		/// Get: Initialization has finished, successfully or not; does not wait
+		/// </summary>
+		const bool IsReady() { return m_ready.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+
+		/// <summary>
+		/// Get: Provider name
+		/// </summary>
+		const char* Name() { return "AsyncCJP"; }
+
+		/// <summary>
+		/// Get: A handle that becomes ready when initialization finishes; its value is the availability of the provider, or the exception thrown by the CJP constructor
+		/// </summary>
+		std::shared_future<bool> Ready() { return m_ready; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate this class and start initializing the provider on a worker thread
+		/// </summary>
+		///
+		/// <param name="Timer">The timestamp source; Auto benchmarks the supported sources and selects the cheapest one that qualifies</param>
+		explicit AsyncCJP(TimerSources Timer = TimerSources::Auto)
+			:
+			m_generator(),
+			m_promise(),
+			m_ready(m_promise.get_future().share()),
+			m_worker()
+		{
+			m_worker = std::thread(&AsyncCJP::Initialize, this, Timer);
+		}
+
+		/// <summary>
+		/// Destructor; waits for initialization to finish
+		/// </summary>
+		~AsyncCJP()
+		{
+			Destroy();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Wait for initialization to finish and release all resources associated with the object
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Fill a buffer with pseudo-random bytes; waits for initialization to finish
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available</exception>
+		void GetBytes(std::vector<byte> &Output);
+
+		/// <summary>
+		/// Fill the buffer with pseudo-random bytes; waits for initialization to finish
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		/// <param name="Offset">The starting position within the Output array</param>
+		/// <param name="Length">The number of bytes to write to the Output array</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available, or the array is too small</exception>
+		void GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length);
+
+		/// <summary>
+		/// Fill a caller owned memory region with pseudo-random bytes; waits for initialization to finish
+		/// </summary>
+		///
+		/// <param name="Output">Pointer to the first byte of the output region</param>
+		/// <param name="Length">The number of bytes to write to the Output region</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available, or the pointer is null</exception>
+		void GetBytes(byte* Output, size_t Length);
+
+		/// <summary>
+		/// Return an array with pseudo-random bytes; waits for initialization to finish
+		/// </summary>
+		///
+		/// <param name="Length">The size of the expected array returned</param>
+		///
+		/// <returns>An array of pseudo-random of bytes</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available</exception>
+		std::vector<byte> GetBytes(size_t Length);
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer; waits for initialization to finish
+		/// </summary>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available</exception>
+		uint32_t Next();
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer; waits for initialization to finish
+		/// </summary>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available</exception>
+		uint32_t NextUInt32();
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 64bit integer; waits for initialization to finish
+		/// </summary>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the provider is not available</exception>
+		uint64_t NextUInt64();
+
+		/// <summary>
+		/// Wait for initialization to finish
+		/// </summary>
+		///
+		/// <returns>The entropy provider is available on this system</returns>
+		///
+		/// <exception cref="CryptoRandomException">An exception thrown by the CJP constructor is rethrown</exception>
+		bool Wait();
+
+	private:
+
+		CJP &Acquire(const std::string &Method);
+		void Initialize(TimerSources Timer);
+	};
+
+}
+#endif
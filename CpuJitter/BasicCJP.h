@@ -0,0 +1,1549 @@
+#ifndef _CEXENGINE_BASICCJP_H
+#define _CEXENGINE_BASICCJP_H
+
+#include "Config.h"
+#include "BitExtractor.h"
+#include "CryptoRandomException.h"
+#include "EntropyEstimator.h"
+#include "HealthTest.h"
+#include "HighResTimer.h"
+#include "JitterStatistics.h"
+#include "NoiseCapture.h"
+#include "NoiseBuffer.h"
+#include "NumaTopology.h"
+#include "PerfCounter.h"
+#include "PoolMixer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CpuJitter
+{
+	//~~~Timer Policies~~~//
+
+	/// <summary>
+	/// A timer policy that selects the timestamp source when the provider is constructed, and reads it through a function pointer
+	/// </summary>
+	class RuntimeTimer
+	{
+	private:
+		HighResTimer::TimerFunction m_timerFunc;
+		TimerSources m_timerSource;
+
+	public:
+
+		RuntimeTimer()
+			:
+			m_timerFunc(&HighResTimer::Default),
+			m_timerSource(TimerSources::Default)
+		{
+		}
+
+		/// <summary>
+		/// Get the sources to qualify, in order of preference; Auto ranks every supported source by read cost
+		/// </summary>
+		std::vector<TimerSources> Rank(TimerSources Timer)
+		{
+			if (Timer == TimerSources::Auto)
+				return HighResTimer::Ranked();
+
+			std::vector<TimerSources> sources;
+
+			if (HighResTimer::Function(Timer) != 0)
+				sources.push_back(Timer);
+
+			return sources;
+		}
+
+		/// <summary>
+		/// Get the timestamp source in use
+		/// </summary>
+		TimerSources Source() const { return m_timerSource; }
+
+		/// <summary>
+		/// Read the timestamp
+		/// </summary>
+		uint64_t TimeStamp() const { return m_timerFunc(); }
+
+		/// <summary>
+		/// Switch to a timestamp source
+		/// </summary>
+		bool Use(TimerSources Timer)
+		{
+			HighResTimer::TimerFunction func = HighResTimer::Function(Timer);
+
+			if (func == 0)
+				return false;
+
+			m_timerFunc = func;
+			m_timerSource = Timer;
+
+			return true;
+		}
+	};
+
+	/// <summary>
+	/// A timer policy bound to a single timestamp source at compile time; the read is inlined into the measurement loop
+	/// </summary>
+	///
+	/// <typeparam name="Timer">The timestamp source</typeparam>
+	/// <typeparam name="Read">The inline read function of the source</typeparam>
+	template <TimerSources Timer, HighResTimer::TimerFunction Read>
+	class StaticTimer
+	{
+	public:
+
+		/// <summary>
+		/// Get the bound source if it is supported and matches the requested source
+		/// </summary>
+		std::vector<TimerSources> Rank(TimerSources Source)
+		{
+			std::vector<TimerSources> sources;
+
+			if ((Source == TimerSources::Auto || Source == Timer) && HighResTimer::Function(Timer) != 0)
+				sources.push_back(Timer);
+
+			return sources;
+		}
+
+		/// <summary>
+		/// Get the timestamp source in use
+		/// </summary>
+		TimerSources Source() const { return Timer; }
+
+		/// <summary>
+		/// Read the timestamp
+		/// </summary>
+		uint64_t TimeStamp() const { return Read(); }
+
+		/// <summary>
+		/// The source is fixed; always succeeds
+		/// </summary>
+		bool Use(TimerSources) { return true; }
+	};
+
+	/// <summary>
+	/// Read the time stamp counter with RDTSC
+	/// </summary>
+	typedef StaticTimer<TimerSources::Rdtsc, &HighResTimer::Rdtsc> RdtscTimer;
+
+	/// <summary>
+	/// Read the time stamp counter with RDTSC behind an LFENCE
+	/// </summary>
+	typedef StaticTimer<TimerSources::LfenceRdtsc, &HighResTimer::LfenceRdtsc> LfenceRdtscTimer;
+
+	/// <summary>
+	/// Read clock_gettime(CLOCK_MONOTONIC)
+	/// </summary>
+	typedef StaticTimer<TimerSources::ClockMonotonic, &HighResTimer::ClockMonotonic> MonotonicTimer;
+
+	//~~~Switch Policies~~~//
+
+	/// <summary>
+	/// A stage that is compiled in or out; the disabled branch is removed by the compiler
+	/// </summary>
+	///
+	/// <typeparam name="Enable">The stage is enabled</typeparam>
+	template <bool Enable>
+	class StaticSwitch
+	{
+	public:
+
+		/// <summary>
+		/// Get: The stage is enabled
+		/// </summary>
+		bool Enabled() const { return Enable; }
+	};
+
+	/// <summary>
+	/// A stage that is switched on or off at runtime
+	/// </summary>
+	class RuntimeSwitch
+	{
+	private:
+		bool m_enabled;
+
+	public:
+
+		explicit RuntimeSwitch(bool Enable = true)
+			:
+			m_enabled(Enable)
+		{
+		}
+
+		/// <summary>
+		/// Get/Set: The stage is enabled
+		/// </summary>
+		bool &Enabled() { return m_enabled; }
+	};
+
+	/// <summary>
+	/// Noise policy: always inject memory access delays
+	/// </summary>
+	typedef StaticSwitch<true> MemoryNoise;
+
+	/// <summary>
+	/// Noise policy: measure CPU execution jitter only
+	/// </summary>
+	typedef StaticSwitch<false> NoMemoryNoise;
+
+	/// <summary>
+	/// Noise policy: memory access noise is enabled with the EnableAccess property
+	/// </summary>
+	typedef RuntimeSwitch RuntimeNoise;
+
+	/// <summary>
+	/// Mix policy: always stir the pool after each 64bit word
+	/// </summary>
+	typedef StaticSwitch<true> StirPoolMix;
+
+	/// <summary>
+	/// Mix policy: the pool is not stirred
+	/// </summary>
+	typedef StaticSwitch<false> NoMix;
+
+	/// <summary>
+	/// Mix policy: pool stirring is enabled with the EnableStir property
+	/// </summary>
+	typedef RuntimeSwitch RuntimeMix;
+
+	//~~~Extractor Policies~~~//
+
+	/// <summary>
+	/// The extraction state shared by the extractor policies; buffers the output of the block extractors and counts the bits produced per measurement
+	/// </summary>
+	class ExtractorEngine
+	{
+	private:
+		byte m_block[BitExtractor::MAX_BLOCK];
+		uint64_t m_bitCount;
+		uint64_t m_measureCount;
+		byte m_output[BitExtractor::MAX_BLOCK];
+		size_t m_outLength;
+		size_t m_outPosition;
+
+	public:
+
+		ExtractorEngine()
+			:
+			m_bitCount(0),
+			m_measureCount(0),
+			m_outLength(0),
+			m_outPosition(0)
+		{
+			memset(m_block, 0, sizeof(m_block));
+			memset(m_output, 0, sizeof(m_output));
+		}
+
+		/// <summary>
+		/// Wipe the buffered bits and reset the counters
+		/// </summary>
+		void Clear()
+		{
+			memset(m_block, 0, sizeof(m_block));
+			memset(m_output, 0, sizeof(m_output));
+			m_bitCount = 0;
+			m_measureCount = 0;
+			m_outLength = 0;
+			m_outPosition = 0;
+		}
+
+		/// <summary>
+		/// Get: The number of extracted bits produced per measurement since construction or the last Clear
+		/// </summary>
+		double Efficiency() const
+		{
+			return (m_measureCount == 0) ? 0.0 : static_cast<double>(m_bitCount) / static_cast<double>(m_measureCount);
+		}
+
+		/// <summary>
+		/// Produce one extracted bit
+		/// </summary>
+		///
+		/// <param name="Type">The extractor</param>
+		/// <param name="Sample">Returns one raw measurement in the low bit</param>
+		/// <param name="Counters">The provider's hot path counters</param>
+		template <typename Measure>
+		uint64_t Extract(Extractors Type, Measure &Sample, JitterCounters &Counters)
+		{
+			if (Type == Extractors::None)
+			{
+				++m_measureCount;
+				++m_bitCount;
+				Counters.ExtractorInput();
+				Counters.ExtractorOutput();
+
+				return Sample();
+			}
+
+			if (Type == Extractors::VonNeumann)
+			{
+				// Von Neuman unbias function as explained in RFC 4086 section 4.2; applied per call so that no raw bits are held between calls
+				do
+				{
+					uint64_t a = Sample();
+					uint64_t b = Sample();
+					m_measureCount += 2;
+					Counters.ExtractorInput();
+					Counters.ExtractorInput();
+
+					if (a == b)
+					{
+						Counters.RejectedPair();
+						continue;
+					}
+
+					++m_bitCount;
+					Counters.ExtractorOutput();
+
+					return a;
+				} while (1);
+			}
+
+			// the block extractors can yield nothing from a constant block; sample blocks until output is available
+			while (m_outPosition == m_outLength)
+			{
+				const size_t BLKLEN = BitExtractor::BlockSize(Type);
+
+				for (size_t i = 0; i < BLKLEN; ++i)
+				{
+					m_block[i] = static_cast<byte>(Sample() & 1);
+					Counters.ExtractorInput();
+				}
+
+				m_measureCount += BLKLEN;
+				m_outLength = BitExtractor::Extract(Type, m_block, BLKLEN, m_output);
+				m_outPosition = 0;
+				m_bitCount += m_outLength;
+			}
+
+			uint64_t bit = m_output[m_outPosition];
+			// consumed bits are wiped so the buffer never holds output already given to the pool
+			m_output[m_outPosition] = 0;
+			++m_outPosition;
+			Counters.ExtractorOutput();
+
+			return bit;
+		}
+	};
+
+	/// <summary>
+	/// An extractor policy bound to one extractor at compile time
+	/// </summary>
+	///
+	/// <typeparam name="Type">The extractor</typeparam>
+	template <Extractors Type>
+	class StaticExtractor : public ExtractorEngine
+	{
+	public:
+
+		/// <summary>
+		/// Get: The extractor in use
+		/// </summary>
+		Extractors Extractor() const { return Type; }
+
+		/// <summary>
+		/// Produce one extracted bit
+		/// </summary>
+		template <typename Measure>
+		uint64_t NextBit(Measure &Sample, JitterCounters &Counters) { return Extract(Type, Sample, Counters); }
+	};
+
+	/// <summary>
+	/// An extractor policy selected at runtime with the EnableDebias and Extractor properties; the default is Von Neumann
+	/// </summary>
+	class RuntimeExtractor : public ExtractorEngine
+	{
+	private:
+		bool m_enabled;
+		Extractors m_extractor;
+
+	public:
+
+		RuntimeExtractor()
+			:
+			m_enabled(true),
+			m_extractor(Extractors::VonNeumann)
+		{
+		}
+
+		/// <summary>
+		/// Get/Set: Extraction is enabled; when disabled, raw folded bits are used
+		/// </summary>
+		bool &Enabled() { return m_enabled; }
+
+		/// <summary>
+		/// Get/Set: The extractor used when extraction is enabled
+		/// </summary>
+		Extractors &Extractor() { return m_extractor; }
+
+		/// <summary>
+		/// Produce one extracted bit
+		/// </summary>
+		template <typename Measure>
+		uint64_t NextBit(Measure &Sample, JitterCounters &Counters) { return Extract(m_enabled ? m_extractor : Extractors::None, Sample, Counters); }
+	};
+
+	/// <summary>
+	/// Extractor policy: raw folded bits are used without debiasing
+	/// </summary>
+	typedef StaticExtractor<Extractors::None> NoExtractor;
+
+	/// <summary>
+	/// Extractor policy: the Von Neumann debiasing extractor
+	/// </summary>
+	typedef StaticExtractor<Extractors::VonNeumann> VonNeumannExtractor;
+
+	/// <summary>
+	/// Extractor policy: iterated Von Neumann (Peres) extraction
+	/// </summary>
+	typedef StaticExtractor<Extractors::Peres> PeresExtractor;
+
+	/// <summary>
+	/// Extractor policy: Elias block extraction
+	/// </summary>
+	typedef StaticExtractor<Extractors::Elias> EliasExtractor;
+
+	/// <summary>
+	/// The CPU Jitter entropy Provider, specialized on its timer, noise, extractor and mix stages.
+	/// <para>Each stage is a policy type; a static policy resolves its choice at compile time so that disabled stages are removed and the timestamp read is inlined into the measurement loop,
+	/// a runtime policy keeps the choice in a member that can be changed through the corresponding property.
+	/// The runtime-configurable specialization is the CJP class; a fixed configuration can be named directly, for example: BasicCJP&lt;RdtscTimer, MemoryNoise, VonNeumannExtractor, StirPoolMix&gt;.
+	/// The EnableAccess, EnableDebias and EnableStir properties are only available when the corresponding policy is a runtime policy.</para>
+	/// </summary>
+	///
+	/// <typeparam name="TimerPolicy">The timestamp source; RuntimeTimer or a StaticTimer</typeparam>
+	/// <typeparam name="NoisePolicy">The memory access noise source; RuntimeNoise, MemoryNoise or NoMemoryNoise</typeparam>
+	/// <typeparam name="ExtractorPolicy">The debiasing extractor; RuntimeExtractor, NoExtractor, VonNeumannExtractor, PeresExtractor or EliasExtractor</typeparam>
+	/// <typeparam name="MixPolicy">The pool stirring function; RuntimeMix, StirPoolMix or NoMix</typeparam>
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	class BasicCJP
+	{
+	private:
+		static constexpr size_t ACC_LOOP_BIT_MAX = 7;
+		static constexpr size_t ACC_LOOP_BIT_MIN = 0;
+		static constexpr size_t CLEARCACHE = 100;
+		static constexpr size_t DATA_SIZE_BITS = ((sizeof(uint64_t)) * 8);
+		static constexpr size_t FOLD_LOOP_BIT_MAX = 4;
+		static constexpr size_t FOLD_LOOP_BIT_MIN = 0;
+		static constexpr size_t HARVEST_SAMPLES = 2048;
+		static constexpr size_t HARVEST_WIDTH = 8;
+		static constexpr size_t LOOP_TEST_COUNT = 300;
+		static constexpr size_t LOOP_TEST_MIN = 64;
+		static constexpr size_t MEMORY_ACCESSLOOPS = 256;
+		static constexpr size_t MEMORY_ACCESSES_DRAM = 32;
+		static constexpr size_t MEMORY_ACCESSES_L2 = 128;
+		static constexpr size_t MEMORY_ACCESSES_L3 = 32;
+		static constexpr size_t OVRSMP_RATE_MAX = 128;
+		static constexpr size_t OVRSMP_RATE_MIN = 1;
+
+		bool m_captureSources;
+		JitterCounters m_counters;
+		bool m_enableEstimator;
+		uint64_t m_entropyCredit;
+		EntropyEstimator m_estimator;
+		ExtractorPolicy m_extractor;
+		uint32_t m_harvestBits;
+		uint32_t m_harvestLimit;
+		HealthTest m_health;
+		bool m_isAvailable;
+		uint64_t m_lastDelta;
+		uint64_t m_lastDelta2;
+		uint32_t m_memAccessLoops;
+		uint64_t m_memDelta;
+		HugePages m_memPages;
+		NumaPlacements m_memPlacement;
+		uint32_t m_memPosition;
+		NoiseBuffer m_memState;
+		MemoryTargets m_memTarget;
+		MixPolicy m_mix;
+		MixKernels m_mixKernel;
+		NoisePolicy m_noise;
+		uint32_t m_overSampleRate;
+		bool m_perfEvents;
+		uint64_t m_prevTime;
+		uint64_t m_rndState;
+		bool m_secureCache;
+		PoolMixer::StirFunction m_stirFunc;
+		uint32_t m_stuckTest;
+		TimerPolicy m_timer;
+		double m_timerTicks;
+
+	public:
+
+		BasicCJP(const BasicCJP&) = delete;
+		BasicCJP& operator=(const BasicCJP&) = delete;
+		BasicCJP& operator=(BasicCJP&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get/Set: Enable the memory access noise source.
+		/// <para>Memory access delays are injected into the random generation mechanism; enabled by default.<para>
+		/// </summary>
+		bool &EnableAccess() { return m_noise.Enabled(); }
+
+		/// <summary>
+		/// Get/Set: Enable the debiasing extractor.
+		/// <para>The default and recommended value is true, which enables the bit debiasing extractor.</para>
+		/// </summary>
+		bool &EnableDebias() { return m_extractor.Enabled(); }
+
+		/// <summary>
+		/// Get/Set: Run the streaming SP 800-90B min-entropy estimators on every raw timing delta; disabled by default.
+		/// <para>The estimators cost a few counter updates per measurement and hold a fixed window of EntropyEstimator::WINDOW measurements, which is emptied by Reset.
+		/// Query them with Estimate and RequiredOverSampleRate.</para>
+		/// </summary>
+		bool &EnableEstimator() { return m_enableEstimator; }
+
+		/// <summary>
+		/// Get/Set: Mix the cache miss and branch miss counts of each memory access pass into the pool; disabled by default.
+		/// <para>The counts are read from the calling thread's hardware performance counters, see PerfCounter, and are mixed without entropy credit.
+		/// Where the counters can not be opened the reads return zero and the setting has no effect; PerfCounter::EventsAvailable reports it.</para>
+		/// </summary>
+		bool &EnablePerfEvents() { return m_perfEvents; }
+
+		/// <summary>
+		/// Get/Set: The debiasing extractor used when EnableDebias is set; the default is Von Neumann.
+		/// <para>The Peres and Elias extractors recycle the measurements the Von Neumann extractor discards, and yield several times more output bits per measurement.</para>
+		/// </summary>
+		Extractors &Extractor() { return m_extractor.Extractor(); }
+
+		/// <summary>
+		/// Get: The measured extractor yield; output bits per timing measurement since construction or the last Reset
+		/// </summary>
+		const double ExtractorEfficiency() { return m_extractor.Efficiency(); }
+
+		/// <summary>
+		/// Get/Set: Stir the entropy pool with the SHA-1 derived mixer after each 64bit word; enabled by default
+		/// </summary>
+		bool &EnableStir() { return m_mix.Enabled(); }
+
+		/// <summary>
+		/// Get: The number of entropy bits credited to the pool since construction or the last Reset.
+		/// <para>A word is output once DATA_SIZE_BITS * OverSampleRate bits have been credited; one bit per accepted extractor output, or HarvestBits per accepted measurement in harvest mode.</para>
+		/// </summary>
+		const uint64_t EntropyCredited() { return m_entropyCredit; }
+
+		/// <summary>
+		/// Get: The min-entropy estimates over the most recent measurements; all zero unless EnableEstimator is set
+		/// </summary>
+		const EntropyEstimate Estimate() { return m_estimator.Estimate(); }
+
+		/// <summary>
+		/// Get/Set: The number of entropy bits credited per timing measurement; the default of 1 folds each delta into a single bit.
+		/// <para>A value above 1 enables harvest mode; each delta is folded into 8 bits which are all mixed into the pool, and the measurement is credited with this many bits,
+		/// bounded by HarvestLimit. Fewer measurements are then needed per word, while OverSampleRate still multiplies the entropy credited per word.
+		/// Harvest mode takes the place of the debiasing extractor, the credited bits are conditioned by the pool mixing.</para>
+		/// </summary>
+		uint32_t &HarvestBits() { return m_harvestBits; }
+
+		/// <summary>
+		/// Get: The largest per-measurement credit permitted on this platform.
+		/// <para>The most common value min-entropy estimate (NIST SP800-90B 6.3.1) of 2048 folded deltas, taken once on the first harvest mode request or when this property is read.</para>
+		/// </summary>
+		const uint32_t HarvestLimit();
+
+		/// <summary>
+		/// Get: The state of the continuous SP 800-90B health tests; the Repetition Count and Adaptive Proportion tests run on every raw timing delta.
+		/// <para>A failure stops all output until Reset, which also repeats the startup tests.</para>
+		/// </summary>
+		const HealthStatus Health() { return m_health.Status(); }
+
+		/// <summary>
+		/// Get: The entropy provider is available on this system.
+		/// <para>This value should be tested after class instantiation and before a request for data is made.
+		/// If the timer resolution is too small, a health test has failed, or the provider is otherwise unavailable, requesting data will throw an exception.</para>
+		/// </summary>
+		const bool IsAvailable() { return m_isAvailable && m_health.Status() == HealthStatus::Ok; }
+
+		/// <summary>
+		/// Get: The page backing of the memory noise buffer; lower than MemoryPages if a huge page allocation failed
+		/// </summary>
+		const HugePages MemoryBacking() { return m_memState.Backing(); }
+
+		/// <summary>
+		/// Get: The NUMA node holding the memory noise buffer, or -1 if the placement is left to the operating system
+		/// </summary>
+		const int MemoryNode() { return m_memState.Node(); }
+
+		/// <summary>
+		/// Get/Set: The page backing requested for the memory noise buffer; the default is HugePages::None.
+		/// <para>Huge pages remove the TLB misses from the access chain on the L3 and DRAM targets. A change takes effect at the next Reset.</para>
+		/// </summary>
+		HugePages &MemoryPages() { return m_memPages; }
+
+		/// <summary>
+		/// Get/Set: The NUMA node placement of the memory noise buffer; the default is NumaPlacements::Local.
+		/// <para>The node is resolved from the processor running the constructor or Reset, and is only bound on hosts with more than one node.
+		/// The calling thread is not pinned; to keep it next to the buffer, bind it with NumaTopology::BindThread(MemoryNode()). A change takes effect at the next Reset.</para>
+		/// </summary>
+		NumaPlacements &MemoryPlacement() { return m_memPlacement; }
+
+		/// <summary>
+		/// Get/Set: The memory level targeted by the memory access noise source; the default is MemoryTargets::L2.
+		/// <para>The buffer is walked as a random pointer chain, so every access pays the latency of the targeted level;
+		/// the deeper levels add more timing variance per access and use fewer accesses per measurement. A change takes effect at the next Reset.</para>
+		/// </summary>
+		MemoryTargets &MemoryTarget() { return m_memTarget; }
+
+		/// <summary>
+		/// Get: The pool stirring kernel selected for this processor at construction; every kernel produces the same output
+		/// </summary>
+		const MixKernels MixKernel() { return m_mixKernel; }
+
+		/// <summary>
+		/// Get: Cipher name
+		/// </summary>
+		const char* Name() { return "CJP"; }
+
+		/// <summary>
+		/// Get/Set: The number of overlapping passes through the jitter entropy collector.
+		/// <para>Accepted values are between 1 and 128; the default is 1.
+		/// Increasing this value will increase generation times significantly.</para>
+		/// </summary>
+		uint32_t &OverSampleRate() { return m_overSampleRate; }
+
+		/// <summary>
+		/// Get: The smallest OverSampleRate that covers the credited entropy with the measured min-entropy on this host.
+		/// <para>The credit of each measurement (one bit, or HarvestBits in harvest mode) divided by the matching estimate, rounded up and bounded to 1 through 128.
+		/// Returns 0 until EnableEstimator is set and a full window of measurements has been taken.</para>
+		/// </summary>
+		const uint32_t RequiredOverSampleRate();
+
+		/// <summary>
+		/// Get/Set: Populate the random cache with an unused value after each generation cycle
+		/// <para>Ensures memory resident state between generation calls is always an unused value.
+		/// This value is true by default and a recommended option.</para>
+		/// </summary>
+		bool &SecureCache() { return m_secureCache; }
+
+		/// <summary>
+		/// Get: A snapshot of the hot path counters since construction or the last ResetStatistics.
+		/// <para>The counters are only compiled in when the library is built with CEX_CJP_STATISTICS defined; otherwise every field is zero.
+		/// Measurements divided by Words gives the measurements each word took, see JitterStatistics for the fields.</para>
+		/// </summary>
+		const JitterStatistics Statistics() { return m_counters.Snapshot(m_timerTicks); }
+
+		/// <summary>
+		/// Get: The timestamp source selected at construction
+		/// </summary>
+		const TimerSources TimerSource() { return m_timer.Source(); }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate this class
+		/// <para>With the Auto timer, each supported timestamp source is micro-benchmarked and the cheapest source that passes the timer qualification test is used.
+		/// A specific source can be requested instead; if it is unsupported, does not match a static TimerPolicy, or does not qualify, IsAvailable returns false.</para>
+		/// </summary>
+		///
+		/// <param name="Timer">The timestamp source; the default is Auto</param>
+		explicit BasicCJP(TimerSources Timer = TimerSources::Auto)
+			:
+			m_captureSources(false),
+			m_counters(),
+			m_enableEstimator(false),
+			m_entropyCredit(0),
+			m_estimator(),
+			m_extractor(),
+			m_harvestBits(1),
+			m_harvestLimit(0),
+			m_health(),
+			m_isAvailable(false),
+			m_lastDelta(0),
+			m_lastDelta2(0),
+			m_memAccessLoops(MEMORY_ACCESSLOOPS),
+			m_memDelta(0),
+			m_memPages(HugePages::None),
+			m_memPlacement(NumaPlacements::Local),
+			m_memPosition(0),
+			m_memState(),
+			m_memTarget(MemoryTargets::L2),
+			m_mix(),
+			m_mixKernel(PoolMixer::Select()),
+			m_noise(),
+			m_overSampleRate(OVRSMP_RATE_MIN),
+			m_perfEvents(false),
+			m_prevTime(0),
+			m_rndState(0),
+			m_secureCache(true),
+			m_stirFunc(PoolMixer::Function(m_mixKernel)),
+			m_stuckTest(1),
+			m_timer(),
+			m_timerTicks(0.0)
+		{
+			m_isAvailable = SelectTimer(Timer);
+
+			if (m_isAvailable)
+			{
+				if (JitterCounters::ENABLED)
+					m_timerTicks = TimerReadTicks();
+
+				Prime();
+			}
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~BasicCJP()
+		{
+			Destroy();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Record raw timing measurements to a capture file for offline assessment.
+		/// <para>The measurements are taken through the configured noise path exactly as for output, and each raw delta is written before it is folded;
+		/// nothing is mixed into the pool or credited. The file header describes the processor and this configuration, see NoiseCapture for the format and CaptureReader to read it back.
+		/// The continuous health tests, and the estimators if enabled, see the captured measurements.</para>
+		/// </summary>
+		///
+		/// <param name="FilePath">The path of the capture file; an existing file is replaced</param>
+		/// <param name="Samples">The number of measurements to record</param>
+		/// <param name="SourceTimings">Also record the time spent in the memory access noise source of each measurement; the two extra timestamp reads are part of the recorded deltas</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the timer is not available, or the file can not be written</exception>
+		void Capture(const std::string &FilePath, uint64_t Samples, bool SourceTimings = false);
+
+		/// <summary>
+		/// Release all resources associated with the object
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Fill a buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		void GetBytes(std::vector<byte> &Output);
+
+		/// <summary>
+		/// Fill the buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		/// <param name="Offset">The starting position within the Output array</param>
+		/// <param name="Length">The number of bytes to write to the Output array</param>
+		void GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length);
+
+		/// <summary>
+		/// Fill a caller owned memory region with pseudo-random bytes
+		/// <para>Words are written directly into the callers storage; this overload performs no heap allocation.</para>
+		/// </summary>
+		///
+		/// <param name="Output">Pointer to the first byte of the output region</param>
+		/// <param name="Length">The number of bytes to write to the Output region</param>
+		void GetBytes(byte* Output, size_t Length);
+
+		/// <summary>
+		/// Return an array with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Length">The size of the expected array returned</param>
+		///
+		/// <returns>An array of pseudo-random of bytes</returns>
+		std::vector<byte> GetBytes(size_t Length);
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer
+		/// </summary>
+		uint32_t Next();
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer without heap allocation
+		/// </summary>
+		uint32_t NextUInt32();
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 64bit integer without heap allocation
+		/// </summary>
+		uint64_t NextUInt64();
+
+		/// <summary>
+		/// Reset the internal state
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Zero the hot path counters; Reset does not clear them, so they can be scraped and cleared on their own schedule
+		/// </summary>
+		void ResetStatistics() { m_counters.Reset(); }
+
+	private:
+
+		void AccessMemory();
+		uint32_t EstimateHarvestLimit();
+		void FoldTime(uint64_t TimeStamp, uint64_t &Folded, size_t Width = 1);
+		void Generate(byte* Output, size_t Length);
+		void Generate64();
+		void HealthFailure(byte* Output, size_t Length, const std::string &Method);
+		uint64_t GetTimeStamp();
+		uint64_t MeasureJitter(size_t Width = 1);
+		void MixBit(uint64_t Bit);
+		void Prime();
+		uint64_t RotL64(uint64_t Value, size_t Shift);
+		bool SelectTimer(TimerSources Timer);
+		uint32_t ShuffleLoop(uint32_t LowBits, uint32_t MinShift);
+		void StirPool();
+		void StuckCheck(uint64_t CurrentDelta);
+		bool TimerCheck();
+		double TimerReadTicks();
+	};
+
+	//~~~Properties~~~//
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	const uint32_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::HarvestLimit()
+	{
+		if (m_harvestLimit == 0 && m_isAvailable)
+			m_harvestLimit = EstimateHarvestLimit();
+
+		return m_harvestLimit;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	const uint32_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::RequiredOverSampleRate()
+	{
+		if (!m_enableEstimator || !m_estimator.Ready())
+			return 0;
+
+		const EntropyEstimate EST = m_estimator.Estimate();
+		// harvest mode credits the eight bit fold, the default mode the single folded bit
+		const double CREDIT = (m_harvestBits > 1) ? static_cast<double>(m_harvestBits) : 1.0;
+		const double HMIN = (m_harvestBits > 1) ? EST.SymbolMcv : EST.MinEntropy;
+
+		if (HMIN * OVRSMP_RATE_MAX <= CREDIT)
+			return static_cast<uint32_t>(OVRSMP_RATE_MAX);
+
+		return (std::max)(static_cast<uint32_t>(OVRSMP_RATE_MIN), static_cast<uint32_t>(std::ceil(CREDIT / HMIN)));
+	}
+
+	//~~~Public Methods~~~//
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Capture(const std::string &FilePath, uint64_t Samples, bool SourceTimings)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("CJP:Capture", "High resolution timer not available or too coarse for RNG!");
+
+		CaptureHeader header = CaptureHeader();
+		header.Flags = SourceTimings ? NoiseCapture::FLAG_SOURCES : 0;
+		header.TimerSource = static_cast<uint32_t>(m_timer.Source());
+		header.EnableAccess = m_noise.Enabled() ? 1 : 0;
+		header.MemoryTarget = static_cast<uint32_t>(m_memTarget);
+		header.MemoryBacking = static_cast<uint32_t>(m_memState.Backing());
+		header.MemoryNode = m_memState.Node();
+		header.Extractor = m_extractor.Enabled() ? static_cast<uint32_t>(m_extractor.Extractor()) : 0;
+		header.HarvestBits = m_harvestBits;
+		header.OverSampleRate = m_overSampleRate;
+
+		NoiseCapture capture;
+		capture.Open(FilePath, header);
+		m_captureSources = SourceTimings;
+
+		try
+		{
+			// the first delta spans the time since the previous measurement, it is not recorded
+			MeasureJitter();
+
+			for (uint64_t i = 0; i < Samples; ++i)
+			{
+				MeasureJitter();
+				capture.Sample(m_lastDelta, m_memDelta);
+			}
+		}
+		catch (...)
+		{
+			m_captureSources = false;
+			throw;
+		}
+
+		m_captureSources = false;
+		capture.Close();
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Destroy()
+	{
+		try
+		{
+			m_memState.Destroy();
+		}
+		catch (...)
+		{
+		}
+
+		m_entropyCredit = 0;
+		m_estimator.Reset();
+		m_extractor.Clear();
+		m_harvestBits = 0;
+		m_harvestLimit = 0;
+		m_lastDelta = 0;
+		m_lastDelta2 = 0;
+		m_memDelta = 0;
+		m_memAccessLoops = 0;
+		m_memPosition = 0;
+		m_overSampleRate = 0;
+		m_prevTime = 0;
+		m_rndState = 0;
+		m_secureCache = false;
+		m_stuckTest = 0;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::GetBytes(std::vector<byte> &Output)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("CJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+
+		if (Output.size() != 0)
+			Generate(&Output[0], Output.size());
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("CJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+		if (Offset + Length > Output.size())
+			throw CryptoRandomException("CJP:GetBytes", "The array is too small to fulfill this request!");
+
+		if (Length != 0)
+			Generate(&Output[Offset], Length);
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::GetBytes(byte* Output, size_t Length)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("CJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+		if (Output == 0 && Length != 0)
+			throw CryptoRandomException("CJP:GetBytes", "The output pointer can not be null!");
+
+		if (Length != 0)
+			Generate(Output, Length);
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	std::vector<byte> BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::GetBytes(size_t Length)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("CJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+
+		std::vector<byte> data(Length);
+
+		if (Length != 0)
+			Generate(&data[0], data.size());
+
+		return data;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	uint32_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Next()
+	{
+		return NextUInt32();
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	uint32_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::NextUInt32()
+	{
+		return static_cast<uint32_t>(NextUInt64());
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	uint64_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::NextUInt64()
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("CJP:Next", "High resolution timer not available or too coarse for RNG!");
+
+		if (m_health.Status() != HealthStatus::Ok)
+			HealthFailure(0, 0, "CJP:Next");
+
+		Generate64();
+
+		if (m_health.Status() != HealthStatus::Ok)
+			HealthFailure(0, 0, "CJP:Next");
+
+		uint64_t rnd = m_rndState;
+
+		// see Generate; the pool is left holding a value that is never given out
+		if (m_secureCache)
+			Generate64();
+
+		return rnd;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Reset()
+	{
+		Prime();
+	}
+
+	//~~~Private Methods~~~//
+
+	CEX_OPTIMIZE_IGNORE
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::AccessMemory()
+	{
+		// this is a noise source based on variations in memory access times
+		// this function performs memory accesses which will add to the timing variations due to an unknown amount of CPU wait states that need to be
+		// added when accessing memory.
+		// the memory size should be larger than the L1 caches as outlined in the documentation and the associated testing.
+		// the L1 cache has a very high bandwidth, albeit its access rate is usually slower than accessing CPU registers.
+		// therefore, L1 accesses only add minimal variations as the CPU has hardly to wait.
+		// starting with L2, significant variations are added because L2 typically does not belong to the CPU any more and therefore a wider range of CPU wait states is necessary for accesses.
+		// L3 and real memory accesses have even a wider range of wait states. However, to reliably access either L3 or memory, the ec->m_memState memory must be quite large which is usually not desirable.
+		// the buffer is sized for the MemoryTarget level and its cache lines are linked into one random cycle; each access loads the link to the next line,
+		// so the accesses form a dependent chain in an order the prefetchers can not predict, and the position wraps without a modulus
+
+		byte* const BUFFER = m_memState.Data();
+		const size_t ACLCNT = (size_t)(m_memAccessLoops + ShuffleLoop(ACC_LOOP_BIT_MAX, ACC_LOOP_BIT_MIN));
+		uint32_t position = m_memPosition;
+		uint64_t brcMiss = 0;
+		uint64_t cchMiss = 0;
+
+		if (m_perfEvents)
+		{
+			brcMiss = PerfCounter::BranchMisses();
+			cchMiss = PerfCounter::CacheMisses();
+		}
+
+		for (size_t i = 0; i < ACLCNT; ++i)
+		{
+			byte* line = BUFFER + position;
+			// memory access; just add 1 to the counter byte behind the link, wrap at 255; memory access implies read from and write to memory location
+			line[sizeof(uint32_t)] = (line[sizeof(uint32_t)] + 1) & 0xff;
+			// the next position is read from the line just accessed
+			position = *reinterpret_cast<uint32_t*>(line);
+		}
+
+		m_memPosition = position;
+
+		if (m_perfEvents)
+		{
+			// the miss counts of the pass vary with the same cache and predictor state the access chain disturbs; they are mixed but not credited
+			brcMiss = PerfCounter::BranchMisses() - brcMiss;
+			cchMiss = PerfCounter::CacheMisses() - cchMiss;
+			m_rndState = PoolMixer::LfsrBlock(m_rndState, (cchMiss << 16) ^ brcMiss, 32);
+		}
+	}
+	CEX_OPTIMIZE_RESUME
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	uint32_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::EstimateHarvestLimit()
+	{
+		// most common value estimate over the wide folds of live measurements, taken through the configured noise path;
+		// the upper bound of the 99% confidence interval of the most common value probability gives the min-entropy
+		std::vector<size_t> counts(static_cast<size_t>(1) << HARVEST_WIDTH, 0);
+
+		MeasureJitter(HARVEST_WIDTH);
+
+		for (size_t i = 0; i < HARVEST_SAMPLES; ++i)
+			++counts[static_cast<size_t>(MeasureJitter(HARVEST_WIDTH))];
+
+		size_t maxCount = 0;
+
+		for (size_t i = 0; i < counts.size(); ++i)
+			maxCount = (std::max)(maxCount, counts[i]);
+
+		const double PMAX = static_cast<double>(maxCount) / HARVEST_SAMPLES;
+		const double PUPR = (std::min)(1.0, PMAX + 2.576 * std::sqrt(PMAX * (1.0 - PMAX) / (HARVEST_SAMPLES - 1)));
+		const double HMIN = -std::log(PUPR) / std::log(2.0);
+		const uint32_t LIMIT = static_cast<uint32_t>(HMIN);
+
+		return (std::max)(static_cast<uint32_t>(1), (std::min)(LIMIT, static_cast<uint32_t>(HARVEST_WIDTH)));
+	}
+
+	CEX_OPTIMIZE_IGNORE
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::FoldTime(uint64_t TimeStamp, uint64_t &Folded, size_t Width)
+	{
+		// CPU jitter noise source; this is the noise source based on the CPU execution time jitter
+		// this function not only acts as folding operation, but this function's execution is used to measure the CPU execution time jitter.
+		// the time stamp is folded into Width bits; bit i of the stamp is added to bit (i mod Width), a width of one is the parity of the stamp
+
+		const size_t FLDCNT = ShuffleLoop(FOLD_LOOP_BIT_MAX, FOLD_LOOP_BIT_MIN);
+		uint64_t fldTmp = 0;
+
+		for (size_t j = 0; j < FLDCNT; ++j)
+		{
+			size_t fldPos = 0;
+			fldTmp = 0;
+			for (size_t i = 1; (DATA_SIZE_BITS) >= i; ++i)
+			{
+				uint64_t tmp = TimeStamp << (DATA_SIZE_BITS - i);
+				tmp = tmp >> (DATA_SIZE_BITS - 1);
+				fldTmp ^= tmp << fldPos;
+
+				if (++fldPos == Width)
+					fldPos = 0;
+			}
+		}
+
+		Folded = fldTmp;
+	}
+	CEX_OPTIMIZE_RESUME
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Generate(byte* Output, size_t Length)
+	{
+		const size_t RNDSZE = sizeof(uint64_t);
+		byte* const OUTPTR = Output;
+		const size_t OUTLEN = Length;
+
+		if (m_health.Status() != HealthStatus::Ok)
+			HealthFailure(OUTPTR, OUTLEN, "CJP:GetBytes");
+
+		// whole words are stored with a fixed size copy, only the trailing partial word is copied by length
+		while (Length >= RNDSZE)
+		{
+			Generate64();
+
+			// a word produced while a health test failed is never released; the request is cleared as a whole
+			if (m_health.Status() != HealthStatus::Ok)
+				HealthFailure(OUTPTR, OUTLEN, "CJP:GetBytes");
+
+			memcpy(Output, &m_rndState, RNDSZE);
+			Output += RNDSZE;
+			Length -= RNDSZE;
+		}
+
+		if (Length != 0)
+		{
+			Generate64();
+
+			if (m_health.Status() != HealthStatus::Ok)
+				HealthFailure(OUTPTR, OUTLEN, "CJP:GetBytes");
+
+			memcpy(Output, &m_rndState, Length);
+		}
+
+		// To be on the safe side, we generate one more round of entropy which we do not give out to the caller.
+		// That round shall ensure that in case the calling application crashes, memory dumps, pages out,
+		// or due to the CPU Jitter RNG lingering in memory for a long time without being moved and an attacker cracks the application,
+		// all he reads in the entropy pool is a value that is never to be used.
+		// Thus, he does NOT see the previous value that was returned to the caller for cryptographic purposes.
+		// If we use secured memory, do not use this precaution as the secure memory protects the entropy pool.
+		// Moreover, note that using this call reduces the speed of the RNG by up to half
+		if (m_secureCache)
+			Generate64();
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Generate64()
+	{
+		m_counters.Word();
+
+		// priming of the m_prevTime value
+		MeasureJitter();
+
+		// the entropy required for one output word; multiply with OverSampleRate to obtain the oversampling rate requested by the caller
+		const size_t ENTREQ = DATA_SIZE_BITS * m_overSampleRate;
+		const uint32_t HRVCRD = (m_harvestBits > 1) ? (std::min)(m_harvestBits, HarvestLimit()) : 1;
+		size_t entCtr = 0;
+
+		// the health test cutoffs follow the entropy credited to each measurement
+		m_health.Configure(HRVCRD);
+
+		if (HRVCRD > 1)
+		{
+			// harvest mode; every bit of the wide fold is mixed, the measurement is credited with the bounded estimate
+			while (1)
+			{
+				const uint64_t FOLDED = MeasureJitter(HARVEST_WIDTH);
+
+				// all folded bits enter the LFSR in one word-parallel step, equivalent to HARVEST_WIDTH MixBit calls
+				m_rndState = PoolMixer::LfsrBlock(m_rndState, FOLDED, HARVEST_WIDTH);
+
+				// a failed health test ends the word; the caller discards it
+				if (m_health.Status() != HealthStatus::Ok)
+					return;
+
+				// enforce the StuckCheck test; a stuck measurement is mixed but not credited
+				if (m_stuckTest)
+				{
+					m_stuckTest = 0;
+					continue;
+				}
+
+				m_entropyCredit += HRVCRD;
+				entCtr += HRVCRD;
+
+				if (entCtr >= ENTREQ)
+					break;
+			}
+		}
+		else
+		{
+			uint64_t drain = 0;
+			// a failed noise source can feed the extractors constant input they never return from; after a health test failure
+			// the measurements are replaced with alternating bits so the extractor drains and the discarded word can end
+			auto sample = [this, &drain]() { return (m_health.Status() == HealthStatus::Ok) ? MeasureJitter() : (drain ^= 1); };
+
+			while (1)
+			{
+				// with a static extractor policy the extractor selection is resolved at compile time
+				MixBit(m_extractor.NextBit(sample, m_counters));
+
+				if (m_health.Status() != HealthStatus::Ok)
+					return;
+
+				// enforce the StuckCheck test
+				if (m_stuckTest)
+				{
+					m_stuckTest = 0;
+					continue;
+				}
+
+				++m_entropyCredit;
+
+				if (++entCtr >= ENTREQ)
+					break;
+			}
+		}
+
+		if (m_mix.Enabled())
+			StirPool();
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	inline uint64_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::GetTimeStamp()
+	{
+		m_counters.TimerRead();
+
+		return m_timer.TimeStamp();
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::HealthFailure(byte* Output, size_t Length, const std::string &Method)
+	{
+		// nothing generated after the failure leaves the provider; the partial request and the pool are cleared
+		if (Output != 0 && Length != 0)
+			memset(Output, 0, Length);
+
+		m_rndState = 0;
+
+		throw CryptoRandomException(Method, "The continuous health test has failed, the provider must be Reset!", HealthTest::Name(m_health.Status()));
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	uint64_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::MeasureJitter(size_t Width)
+	{
+		// the heart of the entropy generation process; calculate time deltas and use the CPU jitter in the time deltas.
+		// the jitter is folded into Width bits; with the default width this function is the "random bit generator" as it produces one random bit per invocation
+
+		uint64_t delta = 0;
+		uint64_t folded = 0;
+		// the counter reads go to the timer directly so that they are not counted as generator reads; with the counters compiled out they are removed
+		uint64_t memStart = 0;
+
+		m_counters.Measurement();
+
+		// Invoke one noise source before time measurement to add variations
+		if (m_noise.Enabled())
+		{
+			if (m_captureSources)
+			{
+				const uint64_t MEMSTR = GetTimeStamp();
+				AccessMemory();
+				m_memDelta = GetTimeStamp() - MEMSTR;
+				m_counters.Memory(m_memDelta);
+			}
+			else
+			{
+				if (JitterCounters::ENABLED)
+					memStart = m_timer.TimeStamp();
+
+				AccessMemory();
+			}
+		}
+		// Get time stamp and calculate time delta to previous invocation to measure the timing variations
+		uint64_t time = GetTimeStamp();
+
+		if (JitterCounters::ENABLED && memStart != 0)
+			m_counters.Memory(time - memStart);
+
+		delta = time - m_prevTime;
+		m_prevTime = time;
+		// the continuous health tests run on the raw delta, before it is folded
+		m_health.Sample(delta);
+
+		if (m_enableEstimator)
+			m_estimator.Sample(delta);
+		// Now call the next noise sources which also folds the data
+		const uint64_t FLDSTR = JitterCounters::ENABLED ? m_timer.TimeStamp() : 0;
+		FoldTime(delta, folded, Width);
+
+		if (JitterCounters::ENABLED)
+			m_counters.Fold(m_timer.TimeStamp() - FLDSTR);
+
+		// Check whether we have a stuck test measurement; the enforcement is performed after the stuck test value has been mixed into the entropy pool
+		StuckCheck(delta);
+
+		return folded;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	inline void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::MixBit(uint64_t Bit)
+	{
+		// Fibonacci LSFR with polynom of 64, 63, 61, 60; the shift values are the polynom values minus one due to counting bits from 0 to 63.
+		m_rndState ^= Bit;
+		m_rndState ^= ((m_rndState >> 63) & 1);
+		m_rndState ^= ((m_rndState >> 62) & 1);
+		m_rndState ^= ((m_rndState >> 60) & 1);
+		m_rndState ^= ((m_rndState >> 59) & 1);
+		// the current position is always the LSB, the polynom only needs to shift data in from the left without wrap
+		m_rndState = RotL64(m_rndState, 1);
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::Prime()
+	{
+		// this is a reset
+		if (m_memState.Data() != 0)
+		{
+			m_entropyCredit = 0;
+			m_extractor.Clear();
+			m_rndState = 0;
+			m_memPosition = 0;
+			m_lastDelta = 0;
+			m_lastDelta2 = 0;
+			m_prevTime = 0;
+			m_stuckTest = 1;
+		}
+
+		m_health.Reset();
+		m_estimator.Reset();
+
+		// the buffer is rebuilt so that a changed MemoryTarget, MemoryPages or MemoryPlacement takes effect; the timestamp only varies the chain order between instances
+		int memNode = -1;
+
+		if (m_memPlacement != NumaPlacements::Unbound && NumaTopology::NodeCount() > 1)
+		{
+			memNode = NumaTopology::CurrentNode();
+
+			if (memNode >= 0 && m_memPlacement == NumaPlacements::Remote)
+				memNode = static_cast<int>(NumaTopology::RemoteNode(static_cast<size_t>(memNode)));
+		}
+
+		m_memState.Allocate(m_memTarget, m_memPages, GetTimeStamp(), memNode);
+		m_memPosition = 0;
+
+		switch (m_memTarget)
+		{
+			case MemoryTargets::L2:
+				m_memAccessLoops = MEMORY_ACCESSES_L2;
+				break;
+			case MemoryTargets::L3:
+				m_memAccessLoops = MEMORY_ACCESSES_L3;
+				break;
+			case MemoryTargets::Dram:
+				m_memAccessLoops = MEMORY_ACCESSES_DRAM;
+				break;
+			default:
+				// every line of the L1 buffer is visited twice, as in the original stride walk
+				m_memAccessLoops = static_cast<uint32_t>(m_memState.Lines() * 2);
+				break;
+		}
+
+		// verify oversampling rate; minimum sampling rate is 1
+		if (m_overSampleRate == 0)
+			m_overSampleRate = 1;
+
+		// SP 800-90B startup testing; the first samples must pass the health tests before any output is produced, they are mixed but not credited
+		MeasureJitter();
+
+		for (size_t i = 0; i < HealthTest::STARTUP_SAMPLES; ++i)
+			MixBit(MeasureJitter());
+
+		// fill the state with non-zero values
+		Generate64();
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	inline uint64_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::RotL64(uint64_t Value, size_t Shift)
+	{
+		return (Value << Shift) | (Value >> (sizeof(uint64_t) * 8 - Shift));
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	bool BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::SelectTimer(TimerSources Timer)
+	{
+		// the candidates arrive cheapest first; take the first one that qualifies
+		std::vector<TimerSources> sources = m_timer.Rank(Timer);
+
+		for (size_t i = 0; i < sources.size(); ++i)
+		{
+			if (m_timer.Use(sources[i]) && TimerCheck())
+				return true;
+		}
+
+		return false;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	uint32_t BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::ShuffleLoop(uint32_t LowBits, uint32_t MinShift)
+	{
+		// update of the loop count used for the next round of an entropy collection
+
+		const uint32_t SHFMSK = (1 << LowBits) - 1;
+		uint64_t shuffle = 0;
+
+		// store the timestamp
+		uint64_t time = GetTimeStamp();
+		// mix the current state of the random number into the shuffle calculation to balance that shuffle a bit more
+		time ^= m_rndState;
+
+		// fold the time value as much as possible to ensure that as many bits of the time stamp are included as possible
+		for (size_t i = 0; (DATA_SIZE_BITS / LowBits) > i; ++i)
+		{
+			shuffle ^= time & SHFMSK;
+			time = time >> LowBits;
+		}
+
+		// add a lower boundary value to ensure we have a minimum RNG loop count
+		return (uint32_t)(shuffle + (1 << MinShift));
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::StirPool()
+	{
+		// shuffle the pool by mixing a value derived from the pool with a bijective function (XOR) into the pool;
+		// the mixer value is not assumed to contain any entropy, but due to the XOR operation it can also not destroy any entropy present in the pool.
+		// the kernel is chosen once from the processor features, see PoolMixer::StirScalar for the reference loop
+		m_rndState = m_stirFunc(m_rndState);
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	void BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::StuckCheck(uint64_t CurrentDelta)
+	{
+		// checks the 1st derivation of the jitter measurement (time delta),
+		// 2nd derivation of the jitter measurement (delta of time deltas),
+		// and the 3rd derivation of the jitter measurement (delta of delta of time deltas).
+		// 0 jitter measurement not stuck test (good bit), 1 jitter measurement stuck test (reject bit).
+
+		const uint64_t DELTA2 = m_lastDelta - CurrentDelta;
+		const uint64_t DELTA3 = DELTA2 - m_lastDelta2;
+
+		m_lastDelta = CurrentDelta;
+		m_lastDelta2 = DELTA2;
+
+		if (CurrentDelta == 0 || DELTA2 == 0 || DELTA3 == 0)
+		{
+			m_stuckTest = 1;
+			m_counters.Stuck();
+		}
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	bool BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::TimerCheck()
+	{
+		uint64_t sumDelta = 0;
+		uint64_t oldDelta = 0;
+		size_t backCtr = 0;
+		size_t varCtr = 0;
+		size_t modCtr = 0;
+
+		for (size_t i = 0; (LOOP_TEST_COUNT + CLEARCACHE) > i; i++)
+		{
+			uint64_t delta = 0;
+			uint64_t folded = 0;
+
+			uint64_t time = GetTimeStamp();
+			FoldTime(time, folded);
+			uint64_t time2 = GetTimeStamp();
+
+			// test whether timer works
+			if (time == 0 || time2 == 0)
+				return false;
+
+			delta = time2 - time;
+			// test whether timer is fine grained enough to provide delta even when called shortly after each other;
+			// this implies that we also have a high resolution timer
+			if (delta == 0)
+				return false;
+
+			// up to here we did not modify any variable that will be evaluated later, but we already performed some work;
+			// thus we already have had an impact on the caches, branch prediction, etc. with the goal to clear it to get the worst case measurements
+			if (i < CLEARCACHE)
+				continue;
+
+			// test whether we have an increasing timer
+			if (time2 <= time)
+				backCtr++;
+
+			if (delta % 100 == 0)
+				modCtr++;
+
+			// ensure that we have a varying delta timer which is necessary for the calculation of entropy;
+			// perform this check only after the first loop is executed as we need to prime the oldDelta value
+			if (i != 0)
+			{
+				if (delta != oldDelta)
+					varCtr++;
+				if (delta > oldDelta)
+					sumDelta += (delta - oldDelta);
+				else
+					sumDelta += (oldDelta - delta);
+			}
+
+			oldDelta = delta;
+
+			// the test is sequential; the limits below are those of the full run, so a timer that has already exceeded one fails at once
+			if (3 < backCtr || ((LOOP_TEST_COUNT / 10) * 9) < modCtr)
+				return false;
+
+			// a timer that is clearly good after the minimum number of samples is accepted without the rest of the run:
+			// it has never run backwards, its deltas vary on at least half of the samples, and at most one in ten is a multiple of 100, far inside the 90% limit.
+			// anything less clear-cut runs to the full count and is judged by the original limits
+			const size_t SMPCNT = i - CLEARCACHE + 1;
+
+			if (SMPCNT >= LOOP_TEST_MIN && backCtr == 0 && sumDelta > 1 && varCtr * 2 >= SMPCNT && modCtr * 10 <= SMPCNT)
+				return true;
+		}
+
+		// we allow up to three times the time running backwards. CLOCK_REALTIME is affected by adjtime and NTP operations.
+		// Thus, if such an operation just happens to interfere with our test, it should not fail. The value of 3 should cover the NTP case being performed during our test run.
+		if (3 < backCtr)
+			return false;
+		// Error if the time variances are always identical
+		if (sumDelta == 0)
+			return false;
+		// Variations of deltas of time must on average be larger than 1 to ensure the entropy estimation implied with 1 is preserved
+		if (sumDelta <= 1)
+			return false;
+		// Ensure that we have variations in the time stamp below 10 for at least 10% of all checks;
+		// on some platforms, the counter increments in multiples of 100
+		if (((LOOP_TEST_COUNT / 10) * 9) < modCtr)
+			return false;
+
+		return true;
+	}
+
+	template <typename TimerPolicy, typename NoisePolicy, typename ExtractorPolicy, typename MixPolicy>
+	double BasicCJP<TimerPolicy, NoisePolicy, ExtractorPolicy, MixPolicy>::TimerReadTicks()
+	{
+		// the cost of one read in the timer's own ticks, for the TimerTicks estimate; the best of a few runs of back to back reads
+		const size_t RDCNT = 64;
+		volatile uint64_t sink = 0;
+		double best = 0.0;
+
+		for (size_t i = 0; i < 8; ++i)
+		{
+			const uint64_t START = m_timer.TimeStamp();
+
+			for (size_t j = 0; j < RDCNT; ++j)
+				sink += m_timer.TimeStamp();
+
+			const double TICKS = static_cast<double>(m_timer.TimeStamp() - START) / (RDCNT + 1);
+
+			if (i == 0 || TICKS < best)
+				best = TICKS;
+		}
+
+		return best;
+	}
+}
+#endif
@@ -0,0 +1,186 @@
+#include "BitExtractor.h"
+#include "CryptoRandomException.h"
+
+namespace CpuJitter
+{
+	//~~~Public Methods~~~//
+
+	size_t BitExtractor::BlockSize(Extractors Type)
+	{
+		switch (Type)
+		{
+			case Extractors::VonNeumann:
+				return 2;
+			case Extractors::Peres:
+				return 64;
+			case Extractors::Elias:
+				return 32;
+			default:
+				return 1;
+		}
+	}
+
+	size_t BitExtractor::Elias(const byte* Input, size_t Length, byte* Output)
+	{
+		if (Length > MAX_BLOCK)
+			throw CryptoRandomException("BitExtractor:Elias", "The block can not be larger than 64 bits!");
+
+		size_t ones = 0;
+
+		for (size_t i = 0; i < Length; ++i)
+			ones += Input[i];
+
+		// the rank of the block among all blocks of the same weight; every rank in [0, total) is equally likely for independent input
+		uint64_t rank = 0;
+		size_t remain = ones;
+
+		for (size_t i = 0; i < Length && remain != 0; ++i)
+		{
+			if (Input[i] != 0)
+			{
+				// blocks with a zero here and the same prefix are ordered before this one
+				rank += Binomial(Length - i - 1, remain);
+				--remain;
+			}
+		}
+
+		// split the weight class into power of two sized intervals, largest first, and emit the offset within the interval holding the rank
+		uint64_t total = Binomial(Length, ones);
+		size_t outLen = 0;
+
+		for (size_t j = 64; j-- > 0;)
+		{
+			const uint64_t INTERVAL = static_cast<uint64_t>(1) << j;
+
+			if ((total & INTERVAL) == 0)
+				continue;
+
+			if (rank < INTERVAL)
+			{
+				for (size_t k = j; k-- > 0;)
+					Output[outLen++] = static_cast<byte>((rank >> k) & 1);
+
+				break;
+			}
+
+			rank -= INTERVAL;
+		}
+
+		return outLen;
+	}
+
+	size_t BitExtractor::Extract(Extractors Type, const byte* Input, size_t Length, byte* Output)
+	{
+		switch (Type)
+		{
+			case Extractors::VonNeumann:
+				return VonNeumann(Input, Length, Output);
+			case Extractors::Peres:
+				return Peres(Input, Length, Output);
+			case Extractors::Elias:
+				return Elias(Input, Length, Output);
+			default:
+			{
+				memcpy(Output, Input, Length);
+				return Length;
+			}
+		}
+	}
+
+	const char* BitExtractor::Name(Extractors Type)
+	{
+		switch (Type)
+		{
+			case Extractors::None:
+				return "None";
+			case Extractors::VonNeumann:
+				return "VonNeumann";
+			case Extractors::Peres:
+				return "Peres";
+			case Extractors::Elias:
+				return "Elias";
+			default:
+				return "Unknown";
+		}
+	}
+
+	size_t BitExtractor::Peres(const byte* Input, size_t Length, byte* Output)
+	{
+		if (Length > MAX_BLOCK)
+			throw CryptoRandomException("BitExtractor:Peres", "The block can not be larger than 64 bits!");
+
+		return PeresLevel(Input, Length, Output);
+	}
+
+	size_t BitExtractor::VonNeumann(const byte* Input, size_t Length, byte* Output)
+	{
+		size_t outLen = 0;
+
+		for (size_t i = 0; i + 1 < Length; i += 2)
+		{
+			if (Input[i] != Input[i + 1])
+				Output[outLen++] = Input[i];
+		}
+
+		return outLen;
+	}
+
+	//~~~Private Methods~~~//
+
+	uint64_t BitExtractor::Binomial(size_t N, size_t K)
+	{
+		// Pascal's triangle up to the block limit; C(64, 32) is the largest entry and fits a 64bit integer
+		struct Table
+		{
+			uint64_t Values[MAX_BLOCK + 1][MAX_BLOCK + 1];
+
+			Table()
+			{
+				memset(Values, 0, sizeof(Values));
+
+				for (size_t n = 0; n <= MAX_BLOCK; ++n)
+				{
+					Values[n][0] = 1;
+
+					for (size_t k = 1; k <= n; ++k)
+						Values[n][k] = Values[n - 1][k - 1] + ((k < n) ? Values[n - 1][k] : 0);
+				}
+			}
+		};
+
+		static const Table PASCAL;
+
+		return (K > N) ? 0 : PASCAL.Values[N][K];
+	}
+
+	size_t BitExtractor::PeresLevel(const byte* Input, size_t Length, byte* Output)
+	{
+		if (Length < 2)
+			return 0;
+
+		const size_t PRSCNT = Length / 2;
+		byte parity[MAX_BLOCK / 2];
+		byte equal[MAX_BLOCK / 2];
+		size_t eqLen = 0;
+		size_t outLen = 0;
+
+		for (size_t i = 0; i < PRSCNT; ++i)
+		{
+			const byte A = Input[2 * i];
+			const byte B = Input[2 * i + 1];
+
+			parity[i] = A ^ B;
+
+			if (A != B)
+				Output[outLen++] = A;
+			else
+				equal[eqLen++] = A;
+		}
+
+		// the parities and the values of the equal pairs are independent of the Von Neumann output and of each other
+		outLen += PeresLevel(parity, PRSCNT, Output + outLen);
+		outLen += PeresLevel(equal, eqLen, Output + outLen);
+
+		return outLen;
+	}
+}
@@ -0,0 +1,115 @@
+#ifndef _CEXENGINE_BITEXTRACTOR_H
+#define _CEXENGINE_BITEXTRACTOR_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The randomness extractors available to the jitter providers
+	/// </summary>
+	enum class Extractors : int
+	{
+		/// <summary>
+		/// Raw folded bits are used without debiasing; one output bit per measurement
+		/// </summary>
+		None = 0,
+		/// <summary>
+		/// The Von Neumann extractor; a pair of unequal measurements yields one bit, at most 0.25 bits per measurement
+		/// </summary>
+		VonNeumann = 1,
+		/// <summary>
+		/// Iterated Von Neumann (Peres) extraction over 64 measurement blocks; the discarded pair information is recycled recursively
+		/// </summary>
+		Peres = 2,
+		/// <summary>
+		/// Elias block extraction over 32 measurement blocks; the rank of each block within its weight class is emitted
+		/// </summary>
+		Elias = 3
+	};
+
+	/// <summary>
+	/// Unbiasing randomness extractors over blocks of independent bits.
+	/// <para>Input and output blocks hold one bit per byte, with a value of 0 or 1.
+	/// Every extractor produces unbiased output from independent input bits of a constant unknown bias,
+	/// the iterated Von Neumann and Elias extractors approach the Shannon entropy of the input as the block length grows.</para>
+	/// </summary>
+	class BitExtractor
+	{
+	public:
+		/// <summary>
+		/// The largest block accepted by the extractors
+		/// </summary>
+		static const size_t MAX_BLOCK = 64;
+
+		/// <summary>
+		/// Get the number of input bits consumed by one block of an extractor
+		/// </summary>
+		///
+		/// <param name="Type">The extractor</param>
+		static size_t BlockSize(Extractors Type);
+
+		/// <summary>
+		/// Elias extraction; emits the lexicographic rank of the block among the blocks with the same number of set bits
+		/// </summary>
+		///
+		/// <param name="Input">The input bits</param>
+		/// <param name="Length">The number of input bits, at most MAX_BLOCK</param>
+		/// <param name="Output">Receives the extracted bits; must hold Length bits</param>
+		///
+		/// <returns>The number of bits written to Output</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the block is larger than MAX_BLOCK</exception>
+		static size_t Elias(const byte* Input, size_t Length, byte* Output);
+
+		/// <summary>
+		/// Extract a block with the selected extractor
+		/// </summary>
+		///
+		/// <param name="Type">The extractor</param>
+		/// <param name="Input">The input bits</param>
+		/// <param name="Length">The number of input bits, at most MAX_BLOCK</param>
+		/// <param name="Output">Receives the extracted bits; must hold Length bits</param>
+		///
+		/// <returns>The number of bits written to Output</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the block is larger than MAX_BLOCK</exception>
+		static size_t Extract(Extractors Type, const byte* Input, size_t Length, byte* Output);
+
+		/// <summary>
+		/// Get the display name of an extractor
+		/// </summary>
+		static const char* Name(Extractors Type);
+
+		/// <summary>
+		/// Iterated Von Neumann extraction (Peres 1992); the Von Neumann output is followed by the extraction of the pair parities and of the values of the equal pairs
+		/// </summary>
+		///
+		/// <param name="Input">The input bits</param>
+		/// <param name="Length">The number of input bits, at most MAX_BLOCK</param>
+		/// <param name="Output">Receives the extracted bits; must hold Length bits</param>
+		///
+		/// <returns>The number of bits written to Output</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the block is larger than MAX_BLOCK</exception>
+		static size_t Peres(const byte* Input, size_t Length, byte* Output);
+
+		/// <summary>
+		/// Von Neumann extraction; the first bit of every unequal pair is emitted
+		/// </summary>
+		///
+		/// <param name="Input">The input bits</param>
+		/// <param name="Length">The number of input bits</param>
+		/// <param name="Output">Receives the extracted bits; must hold Length / 2 bits</param>
+		///
+		/// <returns>The number of bits written to Output</returns>
+		static size_t VonNeumann(const byte* Input, size_t Length, byte* Output);
+
+	private:
+
+		static uint64_t Binomial(size_t N, size_t K);
+		static size_t PeresLevel(const byte* Input, size_t Length, byte* Output);
+	};
+
+}
+#endif
@@ -0,0 +1,157 @@
+#include "CaptureReader.h"
+#include "CryptoRandomException.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CpuJitter
+{
+	//~~~Public Methods~~~//
+
+	void CaptureReader::Close()
+	{
+		m_file.Close();
+		m_header = CaptureHeader();
+	}
+
+	void CaptureReader::Open(const std::string &FilePath)
+	{
+		Close();
+		m_file.Open(FilePath);
+
+		if (m_file.Size() < sizeof(CaptureHeader))
+		{
+			Close();
+			throw CryptoRandomException("CaptureReader:Open", "The file is not a supported noise capture!", FilePath);
+		}
+
+		std::memcpy(&m_header, m_file.Data(), sizeof(CaptureHeader));
+
+		// every field is untrusted; the block size bounds the decode buffers and divides every sample index, the index must fit the file without wrapping
+		const uint64_t FILSZE = m_file.Size();
+
+		if (std::memcmp(m_header.Magic, NoiseCapture::MAGIC, sizeof(m_header.Magic)) != 0 || m_header.Version != NoiseCapture::VERSION ||
+			m_header.BlockSamples == 0 || m_header.BlockSamples > NoiseCapture::BLOCK_SAMPLES)
+		{
+			Close();
+			throw CryptoRandomException("CaptureReader:Open", "The file is not a supported noise capture!", FilePath);
+		}
+
+		const uint64_t BLKMIN = (m_header.SampleCount / m_header.BlockSamples) + ((m_header.SampleCount % m_header.BlockSamples != 0) ? 1 : 0);
+
+		if (m_header.HeaderSize < sizeof(CaptureHeader) || m_header.IndexOffset < m_header.HeaderSize || m_header.IndexOffset > FILSZE ||
+			m_header.BlockCount > (FILSZE - m_header.IndexOffset) / sizeof(uint64_t) || m_header.BlockCount != BLKMIN)
+		{
+			Close();
+			throw CryptoRandomException("CaptureReader:Open", "The capture is incomplete; it was not closed by the writer!", FilePath);
+		}
+	}
+
+	size_t CaptureReader::Read(uint64_t Offset, size_t Count, std::vector<uint64_t> &Deltas)
+	{
+		const uint64_t SMPCNT = m_header.SampleCount;
+
+		Count = static_cast<size_t>((std::min)(static_cast<uint64_t>(Count), (Offset >= SMPCNT) ? 0 : SMPCNT - Offset));
+		Deltas.resize(Count);
+
+		std::vector<uint64_t> block;
+		size_t outPos = 0;
+
+		while (outPos < Count)
+		{
+			const uint64_t SMPIDX = Offset + outPos;
+			const size_t BLKIDX = static_cast<size_t>(SMPIDX / m_header.BlockSamples);
+			const size_t BLKPOS = static_cast<size_t>(SMPIDX % m_header.BlockSamples);
+			const size_t BLKLEN = ReadBlock(BLKIDX, block);
+			const size_t CPYLEN = (std::min)(Count - outPos, BLKLEN - BLKPOS);
+
+			std::memcpy(&Deltas[outPos], &block[BLKPOS], CPYLEN * sizeof(uint64_t));
+			outPos += CPYLEN;
+		}
+
+		return Count;
+	}
+
+	size_t CaptureReader::ReadBlock(size_t Block, std::vector<uint64_t> &Deltas)
+	{
+		if (Block >= m_header.BlockCount)
+			throw CryptoRandomException("CaptureReader:ReadBlock", "The block index is out of range!");
+
+		Deltas.resize(m_header.BlockSamples);
+		const size_t BLKLEN = Decode(Block, Deltas.data(), 0);
+		Deltas.resize(BLKLEN);
+
+		return BLKLEN;
+	}
+
+	size_t CaptureReader::ReadBlock(size_t Block, std::vector<uint64_t> &Deltas, std::vector<uint64_t> &Sources)
+	{
+		if (Block >= m_header.BlockCount)
+			throw CryptoRandomException("CaptureReader:ReadBlock", "The block index is out of range!");
+
+		Deltas.resize(m_header.BlockSamples);
+		Sources.assign(m_header.BlockSamples, 0);
+		const size_t BLKLEN = Decode(Block, Deltas.data(), Sources.data());
+		Deltas.resize(BLKLEN);
+		Sources.resize(BLKLEN);
+
+		return BLKLEN;
+	}
+
+	//~~~Private Methods~~~//
+
+	uint64_t CaptureReader::BlockOffset(size_t Block)
+	{
+		// the index is not aligned; it starts wherever the last block ended
+		uint64_t offset = 0;
+		std::memcpy(&offset, m_file.Data() + m_header.IndexOffset + Block * sizeof(uint64_t), sizeof(uint64_t));
+
+		return offset;
+	}
+
+	size_t CaptureReader::Decode(size_t Block, uint64_t* Deltas, uint64_t* Sources)
+	{
+		const uint64_t BLKSTR = BlockOffset(Block);
+		const uint64_t BLKEND = (Block + 1 == m_header.BlockCount) ? m_header.IndexOffset : BlockOffset(Block + 1);
+		const uint64_t BLKFST = static_cast<uint64_t>(Block) * m_header.BlockSamples;
+		const size_t BLKLEN = static_cast<size_t>((std::min)(static_cast<uint64_t>(m_header.BlockSamples), m_header.SampleCount - BLKFST));
+		const size_t STMCNT = ((m_header.Flags & NoiseCapture::FLAG_SOURCES) != 0) ? 2 : 1;
+
+		if (BLKSTR < m_header.HeaderSize || BLKEND < BLKSTR || BLKEND > m_header.IndexOffset)
+			throw CryptoRandomException("CaptureReader:ReadBlock", "The block index is corrupt!");
+
+		const byte* inPtr = m_file.Data() + BLKSTR;
+		const byte* const INEND = m_file.Data() + BLKEND;
+		uint64_t last[2] = { 0, 0 };
+
+		for (size_t i = 0; i < BLKLEN; ++i)
+		{
+			for (size_t j = 0; j < STMCNT; ++j)
+			{
+				uint64_t value = 0;
+				size_t shift = 0;
+				byte code = 0x80;
+
+				// LEB128; a varint may not run past the end of its block or exceed ten bytes
+				while ((code & 0x80) != 0)
+				{
+					if (inPtr == INEND || shift > 63)
+						throw CryptoRandomException("CaptureReader:ReadBlock", "The capture block is corrupt!");
+
+					code = *inPtr++;
+					value |= static_cast<uint64_t>(code & 0x7F) << shift;
+					shift += 7;
+				}
+
+				// undo the zigzag mapping, then the difference
+				last[j] += (value >> 1) ^ (0 - (value & 1));
+
+				if (j == 0)
+					Deltas[i] = last[0];
+				else if (Sources != 0)
+					Sources[i] = last[1];
+			}
+		}
+
+		return BLKLEN;
+	}
+}
@@ -0,0 +1,140 @@
+#ifndef _CEXENGINE_CAPTUREREADER_H
+#define _CEXENGINE_CAPTUREREADER_H
+
+#include "Config.h"
+#include "MappedFile.h"
+#include "NoiseCapture.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// Reads a raw noise capture file written by NoiseCapture.
+	/// <para>The file is memory mapped read only; the header and block index are validated on Open, and a block is only decoded when it is read,
+	/// so a capture larger than the physical memory can be processed block by block. Blocks decode independently and a reader may be shared by threads that read different blocks.</para>
+	/// </summary>
+	class CaptureReader
+	{
+	private:
+		MappedFile m_file;
+		CaptureHeader m_header;
+
+	public:
+
+		CaptureReader(const CaptureReader&) = delete;
+		CaptureReader& operator=(const CaptureReader&) = delete;
+		CaptureReader& operator=(CaptureReader&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The number of blocks in the capture
+		/// </summary>
+		const size_t Blocks() { return static_cast<size_t>(m_header.BlockCount); }
+
+		/// <summary>
+		/// Get: The number of measurements in every block but the last
+		/// </summary>
+		const size_t BlockSamples() { return m_header.BlockSamples; }
+
+		/// <summary>
+		/// Get: The capture header
+		/// </summary>
+		const CaptureHeader Header() { return m_header; }
+
+		/// <summary>
+		/// Get: The records carry the memory access time
+		/// </summary>
+		const bool HasSources() { return (m_header.Flags & NoiseCapture::FLAG_SOURCES) != 0; }
+
+		/// <summary>
+		/// Get: A capture file is mapped
+		/// </summary>
+		const bool IsOpen() { return m_file.IsOpen(); }
+
+		/// <summary>
+		/// Get: The number of measurements in the capture
+		/// </summary>
+		const uint64_t Samples() { return m_header.SampleCount; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate a closed reader
+		/// </summary>
+		CaptureReader()
+			:
+			m_file(),
+			m_header()
+		{
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~CaptureReader()
+		{
+			Close();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Unmap the file
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Map a capture file and validate its header and block index
+		/// </summary>
+		///
+		/// <param name="FilePath">The path of the capture file</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the file can not be mapped or is not a complete capture</exception>
+		void Open(const std::string &FilePath);
+
+		/// <summary>
+		/// Decode a range of measurements, starting in the block that holds the first
+		/// </summary>
+		///
+		/// <param name="Offset">The index of the first measurement</param>
+		/// <param name="Count">The number of measurements</param>
+		/// <param name="Deltas">Receives the timing deltas; resized to the number read</param>
+		///
+		/// <returns>The number of measurements read; less than Count at the end of the capture</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if a block is corrupt</exception>
+		size_t Read(uint64_t Offset, size_t Count, std::vector<uint64_t> &Deltas);
+
+		/// <summary>
+		/// Decode the timing deltas of one block
+		/// </summary>
+		///
+		/// <param name="Block">The block index</param>
+		/// <param name="Deltas">Receives the timing deltas; resized to the block length</param>
+		///
+		/// <returns>The number of measurements in the block</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the block index is out of range or the block is corrupt</exception>
+		size_t ReadBlock(size_t Block, std::vector<uint64_t> &Deltas);
+
+		/// <summary>
+		/// Decode the timing deltas and memory access times of one block
+		/// </summary>
+		///
+		/// <param name="Block">The block index</param>
+		/// <param name="Deltas">Receives the timing deltas; resized to the block length</param>
+		/// <param name="Sources">Receives the memory access times, or zeros if the capture has no source timings; resized to the block length</param>
+		///
+		/// <returns>The number of measurements in the block</returns>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the block index is out of range or the block is corrupt</exception>
+		size_t ReadBlock(size_t Block, std::vector<uint64_t> &Deltas, std::vector<uint64_t> &Sources);
+
+	private:
+
+		uint64_t BlockOffset(size_t Block);
+		size_t Decode(size_t Block, uint64_t* Deltas, uint64_t* Sources);
+	};
+
+}
+#endif
@@ -108,7 +108,7 @@ const int CEX_VERSION_PATCH = 0;
 // common functions
 #define MALLOC(x) HeapAlloc(GetProcessHeap(), 0, (x)) 
 #define FREE(x) HeapFree(GetProcessHeap(), 0, (x))
-#define GETBITMASK(index, size) (((1 << (size)) - 1) << (index))
+#define GETBITMASK(index, size) (((1U << (size)) - 1) << (index))
 #define READBITSFROM(data, index, size) (((data) & GETBITMASK((index), (size))) >> (index))
 #define WRITEBITSTO(data, index, size, value) ((data) = ((data) & (~GETBITMASK((index), (size)))) | ((value) << (index)))
 
@@ -405,9 +405,9 @@ const unsigned int WORD_BITS = WORD_SIZE * 8;
 #if defined(CEX_COMPILER_MSC)
 #	define CEX_OPTIMIZE_IGNORE __pragma(optimize("", off))
 #elif defined(CEX_COMPILER_GCC) || defined(CEX_COMPILER_MINGW)
-#	define CEX_OPTIMIZE_IGNORE _Pragma(TOSTRING(GCC optimize("O0")))
+#	define CEX_OPTIMIZE_IGNORE _Pragma(TOSTRING(GCC push_options)) _Pragma(TOSTRING(GCC optimize("O0")))
 #elif defined(CEX_COMPILER_CLANG)
-#	define CEX_OPTIMIZE_IGNORE __attribute__((optnone))
+#	define CEX_OPTIMIZE_IGNORE _Pragma(TOSTRING(clang optimize off))
 #elif defined(CEX_COMPILER_INTEL)
 #	define CEX_OPTIMIZE_IGNORE pragma optimize("", off) 
 #else
@@ -419,12 +419,26 @@ const unsigned int WORD_BITS = WORD_SIZE * 8;
 #	define CEX_OPTIMIZE_RESUME __pragma(optimize("", on))
 #elif defined(CEX_COMPILER_GCC) || defined(CEX_COMPILER_MINGW)
 #	define CEX_OPTIMIZE_RESUME _Pragma(TOSTRING(GCC pop_options))
+#elif defined(CEX_COMPILER_CLANG)
+#	define CEX_OPTIMIZE_RESUME _Pragma(TOSTRING(clang optimize on))
 #elif defined(CEX_COMPILER_INTEL)
 #	define CEX_OPTIMIZE_RESUME pragma optimize("", on) 
 #else
 #	define CEX_OPTIMIZE_RESUME 0
 #endif
 
+// enables an instruction set extension on a single function, so that kernels selected at runtime from CpuDetect flags
+// can be compiled without raising the architecture of the whole project; msvc emits any intrinsic without this attribute
+#if defined(CEX_COMPILER_GCC) || defined(CEX_COMPILER_MINGW) || defined(CEX_COMPILER_CLANG)
+#	define CEX_TARGET_ISA(x) __attribute__((target(x)))
+#else
+#	define CEX_TARGET_ISA(x)
+#endif
+
+// compiles in the per instance hot path counters of the jitter providers, see JitterStatistics;
+// when not defined the counters and the timestamp reads that feed them are removed, and the Statistics properties return zeros
+//#define CEX_CJP_STATISTICS
+
 // EOF
 #endif
 
@@ -1,8 +1,102 @@
 #include "CpuDetect.h"
-
+#include <cstdlib>
+#include <mutex>
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#elif defined(CEX_OS_LINUX)
+#	include <fstream>
+#	include <sched.h>
+#endif
 
 namespace CpuJitter
 {
+	namespace
+	{
+		struct SnapshotState
+		{
+			std::mutex Lock;
+			std::shared_ptr<CpuDetect> Current;
+		};
+
+		SnapshotState &GlobalSnapshot()
+		{
+			// a function local static so that the state is constructed before its first use from any translation unit
+			static SnapshotState state;
+
+			return state;
+		}
+	}
+
+	//~~~ Public Methods~~~//
+
+	std::vector<size_t> CpuDetect::AllowedProcessors()
+	{
+		std::vector<size_t> cpus;
+
+#if defined(CEX_OS_WINDOWS)
+		// windows has no thread affinity query; the process mask bounds every thread of the process
+		DWORD_PTR prcMask = 0;
+		DWORD_PTR sysMask = 0;
+
+		if (GetProcessAffinityMask(GetCurrentProcess(), &prcMask, &sysMask))
+		{
+			for (size_t i = 0; i < sizeof(DWORD_PTR) * 8; ++i)
+			{
+				if ((prcMask >> i) & 1)
+					cpus.push_back(i);
+			}
+		}
+#elif defined(CEX_OS_LINUX)
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+
+		if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0)
+		{
+			for (size_t i = 0; i < CPU_SETSIZE; ++i)
+			{
+				if (CPU_ISSET(i, &cpuSet))
+					cpus.push_back(i);
+			}
+		}
+#endif
+
+		return cpus;
+	}
+
+	CpuDetect::CacheInfo CpuDetect::DataCache(uint32_t Level)
+	{
+		for (size_t i = 0; i < m_caches.size(); ++i)
+		{
+			if (m_caches[i].Level == Level && m_caches[i].Type != CacheTypes::Instruction)
+				return m_caches[i];
+		}
+
+		CacheInfo info = { 0, CacheTypes::Unified, 0, 0, 0, 0, 0 };
+
+		return info;
+	}
+
+	void CpuDetect::Refresh()
+	{
+		// detected outside the lock; readers keep the old snapshot until the new one is swapped in
+		std::shared_ptr<CpuDetect> snap = std::make_shared<CpuDetect>();
+		SnapshotState &state = GlobalSnapshot();
+		std::lock_guard<std::mutex> lock(state.Lock);
+
+		state.Current = snap;
+	}
+
+	std::shared_ptr<CpuDetect> CpuDetect::Snapshot()
+	{
+		SnapshotState &state = GlobalSnapshot();
+		std::lock_guard<std::mutex> lock(state.Lock);
+
+		if (!state.Current)
+			state.Current = std::make_shared<CpuDetect>();
+
+		return state.Current;
+	}
 
 	//~~~ Private Methods~~~//
 
@@ -60,9 +154,8 @@ namespace CpuJitter
 			m_amd3dNowPro = READBITSFROM(cpuInfo[0], 30, 1) != 0;
 			m_amd3dNow = READBITSFROM(cpuInfo[0], 31, 1) != 0;
 
-			m_amdCmpLegacy = (cpuInfo[1], 1, 1) != 0;
-
 			m_sse3 = READBITSFROM(cpuInfo[2], 0, 1) != 0;
+			m_pclmul = READBITSFROM(cpuInfo[2], 1, 1) != 0;
 			m_ssse3 = READBITSFROM(cpuInfo[2], 9, 1) != 0;
 			m_fma3 = READBITSFROM(cpuInfo[2], 12, 1) != 0;
 			m_sse41 = READBITSFROM(cpuInfo[2], 19, 1) != 0;
@@ -79,7 +172,6 @@ namespace CpuJitter
 			m_mmx = READBITSFROM(cpuInfo[3], 23, 1) != 0;
 			m_sse1 = READBITSFROM(cpuInfo[3], 25, 1) != 0;
 			m_sse2 = READBITSFROM(cpuInfo[3], 26, 1) != 0;
-			m_rdtscp = READBITSFROM(cpuInfo[3], 27, 1) != 0;
 			m_hyperThread = READBITSFROM(cpuInfo[3], 28, 1) != 0;
 		}
 
@@ -94,7 +186,7 @@ namespace CpuJitter
 #if defined(MSCAVX)
 			m_avx2 = Avx2Supported();
 #else
-			m_avx2 = (cpuInfo[1], 5, 1) != 0;
+			m_avx2 = READBITSFROM(cpuInfo[1], 5, 1) != 0;
 #endif
 			m_smep = READBITSFROM(cpuInfo[1], 7, 1) != 0;
 			m_bmt2 = READBITSFROM(cpuInfo[1], 8, 1) != 0;
@@ -122,45 +214,466 @@ namespace CpuJitter
 
 			m_avx5124vnniw = READBITSFROM(cpuInfo[3], 2, 1) != 0;
 			m_avx5124fmaps = READBITSFROM(cpuInfo[3], 3, 1) != 0;
+			m_hybrid = READBITSFROM(cpuInfo[3], 15, 1) != 0;
 		}
 
 		if (nExIds >= 0x80000001)
 		{
 			cpuid(cpuInfo, 0x80000001);
 
+			m_amdCmpLegacy = READBITSFROM(cpuInfo[2], 1, 1) != 0;
 			m_abm = READBITSFROM(cpuInfo[2], 5, 1) != 0;
 			m_sse4a = READBITSFROM(cpuInfo[2], 6, 1) != 0;
 			m_xop = READBITSFROM(cpuInfo[2], 11, 1) != 0;
 			m_fma4 = READBITSFROM(cpuInfo[2], 16, 1) != 0;
+			m_rdtscp = READBITSFROM(cpuInfo[3], 27, 1) != 0;
 			m_x64 = READBITSFROM(cpuInfo[3], 29, 1) != 0;
 		}
 
-		// topology
-		m_virtCores = MaxCoresPerPackage();
-		m_physCores = m_hyperThread == true && m_virtCores > 1 ? m_virtCores / 2 : m_virtCores;
-		m_logicalPerCore = MaxLogicalPerCore();
+		if (nExIds >= 0x80000007)
+		{
+			cpuid(cpuInfo, 0x80000007);
+			m_invariantTsc = READBITSFROM(cpuInfo[3], 8, 1) != 0;
+		}
+
+		// topology; counted from the operating system's enumeration, estimated from cpuid without it
+		if (ReadTopology())
+		{
+			std::vector<std::pair<size_t, size_t>> cores;
+			m_logicalPerCore = 1;
+
+			for (size_t i = 0; i < m_processors.size(); ++i)
+			{
+				cores.push_back(std::make_pair(m_processors[i].Package, m_processors[i].Core));
+				m_logicalPerCore = (std::max)(m_logicalPerCore, m_processors[i].Thread + 1);
+			}
+
+			std::sort(cores.begin(), cores.end());
+			m_physCores = static_cast<size_t>(std::unique(cores.begin(), cores.end()) - cores.begin());
+			m_virtCores = m_processors.size();
+		}
+		else
+		{
+			m_virtCores = MaxCoresPerPackage();
+			m_physCores = m_hyperThread == true && m_virtCores > 1 ? m_virtCores / 2 : m_virtCores;
+			m_logicalPerCore = MaxLogicalPerCore();
+		}
 		GetFrequency();
 		GetSerialNumber();
 
-		// TODO: AMD
 		// cache info
-		if ((nExIds & 0xFF) > 5)
+		DetectCaches(static_cast<uint32_t>(nIds), nExIds);
+	}
+
+	void CpuDetect::DetectCaches(uint32_t MaxLeaf, uint32_t MaxExtLeaf)
+	{
+		m_caches.clear();
+
+		// the kernel's description first, then the deterministic cache parameter leaves; leaf 4 is reserved on AMD, which enumerates the same format at 0x8000001D
+		if (!ReadCacheSysfs())
 		{
-			cpuid(cpuInfo, 0x80000006);
+			bool found = false;
+
+			if (MaxLeaf >= 4)
+				found = ReadCacheLeaf(4);
 
-			m_l1CacheSize = static_cast<size_t>(READBITSFROM(cpuInfo[2], 0, 8));
-			m_l1CacheLineSize = static_cast<size_t>(READBITSFROM(cpuInfo[2], 0, 11)); // ?
+			if (!found && MaxExtLeaf >= 0x8000001D)
+			{
+				int cpuInfo[4];
+				cpuid(cpuInfo, 0x80000001);
+
+				// topology extensions
+				if (READBITSFROM(cpuInfo[2], 22, 1) != 0)
+					found = ReadCacheLeaf(0x8000001D);
+			}
+
+			if (!found)
+				ReadCacheLegacy(MaxExtLeaf);
+		}
+
+		// the per core totals in kib used by the L1 and L2 properties
+		for (size_t i = 0; i < m_caches.size(); ++i)
+		{
+			if (m_caches[i].Level == 1)
+			{
+				m_l1CacheSize += m_caches[i].Size / KB1;
+
+				if (m_caches[i].Type != CacheTypes::Instruction)
+					m_l1CacheLineSize = m_caches[i].LineSize;
+			}
+			else if (m_caches[i].Level == 2 && m_caches[i].Type != CacheTypes::Instruction)
+			{
+				m_l2CacheSize = m_caches[i].Size / KB1;
+			}
+		}
+
+		if (MaxExtLeaf >= 0x80000006)
+		{
+			int cpuInfo[4];
+			cpuid(cpuInfo, 0x80000006);
 			m_l2Associative = static_cast<CacheAssociations>(READBITSFROM(cpuInfo[2], 12, 4));
-			m_l2CacheSize = static_cast<size_t>(READBITSFROM(cpuInfo[2], 16, 16));
 		}
+	}
+
+	size_t CpuDetect::LegacyWays(uint32_t Association)
+	{
+		// the associativity encoding of the AMD leaf 0x80000006
+		switch (Association)
+		{
+			case 0x1:
+				return 1;
+			case 0x2:
+				return 2;
+			case 0x4:
+				return 4;
+			case 0x6:
+				return 8;
+			case 0x8:
+				return 16;
+			case 0xA:
+				return 32;
+			case 0xB:
+				return 48;
+			case 0xC:
+				return 64;
+			case 0xD:
+				return 96;
+			case 0xE:
+				return 128;
+			default:
+				return 0;
+		}
+	}
+
+	bool CpuDetect::ReadCacheLeaf(uint32_t Leaf)
+	{
+		int cpuInfo[4];
+
+		// one sub-leaf per cache, terminated by a null type
+		for (int i = 0; i < 16; ++i)
+		{
+			cpuidex(cpuInfo, static_cast<int>(Leaf), i);
+
+			const uint32_t TYPE = READBITSFROM(cpuInfo[0], 0, 5);
+
+			if (TYPE == 0)
+				break;
+			if (TYPE > 3)
+				continue;
+
+			CacheInfo info;
+			info.Level = READBITSFROM(cpuInfo[0], 5, 3);
+			info.Type = static_cast<CacheTypes>(TYPE);
+			info.LineSize = static_cast<size_t>(READBITSFROM(cpuInfo[1], 0, 12)) + 1;
+			info.Ways = READBITSFROM(cpuInfo[0], 9, 1) != 0 ? 0 : static_cast<size_t>(READBITSFROM(cpuInfo[1], 22, 10)) + 1;
+			info.Sets = static_cast<size_t>(static_cast<uint32_t>(cpuInfo[2])) + 1;
+			info.SharedBy = static_cast<size_t>(READBITSFROM(cpuInfo[0], 14, 12)) + 1;
+
+			const size_t PARTS = static_cast<size_t>(READBITSFROM(cpuInfo[1], 12, 10)) + 1;
+			const size_t WAYS = static_cast<size_t>(READBITSFROM(cpuInfo[1], 22, 10)) + 1;
+			info.Size = WAYS * PARTS * info.LineSize * info.Sets;
+
+			m_caches.push_back(info);
+		}
+
+		return m_caches.size() != 0;
+	}
+
+	void CpuDetect::ReadCacheLegacy(uint32_t MaxExtLeaf)
+	{
+		// the AMD L1 and L2/L3 descriptor leaves; Intel reports only the L2 in 0x80000006
+		int cpuInfo[4];
+		CacheInfo info;
+		info.Sets = 0;
+		info.SharedBy = 0;
+
+		if (MaxExtLeaf >= 0x80000005)
+		{
+			cpuid(cpuInfo, 0x80000005);
+
+			for (size_t i = 2; i < 4; ++i)
+			{
+				if (READBITSFROM(cpuInfo[i], 24, 8) == 0)
+					continue;
+
+				const uint32_t ASSOC = READBITSFROM(cpuInfo[i], 16, 8);
+				info.Level = 1;
+				info.Type = (i == 2) ? CacheTypes::Data : CacheTypes::Instruction;
+				info.Size = static_cast<size_t>(READBITSFROM(cpuInfo[i], 24, 8)) * KB1;
+				info.LineSize = static_cast<size_t>(READBITSFROM(cpuInfo[i], 0, 8));
+				info.Ways = (ASSOC == 0xFF) ? 0 : static_cast<size_t>(ASSOC);
+				m_caches.push_back(info);
+			}
+		}
+
+		if (MaxExtLeaf >= 0x80000006)
+		{
+			cpuid(cpuInfo, 0x80000006);
+
+			if (READBITSFROM(cpuInfo[2], 16, 16) != 0)
+			{
+				info.Level = 2;
+				info.Type = CacheTypes::Unified;
+				info.Size = static_cast<size_t>(READBITSFROM(cpuInfo[2], 16, 16)) * KB1;
+				info.LineSize = static_cast<size_t>(READBITSFROM(cpuInfo[2], 0, 8));
+				info.Ways = LegacyWays(READBITSFROM(cpuInfo[2], 12, 4));
+				m_caches.push_back(info);
+			}
+
+			if (READBITSFROM(cpuInfo[3], 18, 14) != 0)
+			{
+				info.Level = 3;
+				info.Type = CacheTypes::Unified;
+				info.Size = static_cast<size_t>(READBITSFROM(cpuInfo[3], 18, 14)) * 512 * KB1;
+				info.LineSize = static_cast<size_t>(READBITSFROM(cpuInfo[3], 0, 8));
+				info.Ways = LegacyWays(READBITSFROM(cpuInfo[3], 12, 4));
+				m_caches.push_back(info);
+			}
+		}
+	}
+
+	bool CpuDetect::ReadCacheSysfs()
+	{
+#if defined(CEX_OS_LINUX)
+		const std::string ROOT = "/sys/devices/system/cpu/cpu0/cache/index";
+
+		for (size_t i = 0; i < 16; ++i)
+		{
+			const std::string DIR = ROOT + std::to_string(i) + "/";
+			std::ifstream levelFile(DIR + "level");
+			size_t level = 0;
+
+			if (!(levelFile >> level))
+				break;
+
+			std::string type;
+			std::string size;
+			std::string shared;
+			size_t line = 0;
+			size_t ways = 0;
+			size_t sets = 0;
+
+			std::ifstream(DIR + "type") >> type;
+			std::ifstream(DIR + "size") >> size;
+			std::ifstream(DIR + "coherency_line_size") >> line;
+			std::ifstream(DIR + "ways_of_associativity") >> ways;
+			std::ifstream(DIR + "number_of_sets") >> sets;
+			std::ifstream(DIR + "shared_cpu_list") >> shared;
+
+			CacheInfo info;
+			info.Level = static_cast<uint32_t>(level);
+			info.Type = (type == "Data") ? CacheTypes::Data : (type == "Instruction") ? CacheTypes::Instruction : CacheTypes::Unified;
+			info.LineSize = line;
+			info.Ways = ways;
+			info.Sets = sets;
+
+			// sizes are written with a K or M suffix
+			char* end = 0;
+			info.Size = static_cast<size_t>(std::strtoul(size.c_str(), &end, 10));
+
+			if (end != 0 && *end == 'K')
+				info.Size *= KB1;
+			else if (end != 0 && *end == 'M')
+				info.Size *= KB1 * KB1;
+
+			info.SharedBy = ParseCpuList(shared).size();
+
+			if (info.Size != 0 && info.LineSize != 0)
+				m_caches.push_back(info);
+		}
+
+		return m_caches.size() != 0;
+#else
+		return false;
+#endif
+	}
+
+	std::vector<size_t> CpuDetect::ParseCpuList(const std::string &List)
+	{
+		// the kernel's processor list format; comma separated indices and inclusive ranges, e.g. 0-3,8-11
+		std::vector<size_t> cpus;
+		const char* pos = List.c_str();
+
+		while (*pos != 0)
+		{
+			char* end = 0;
+			const size_t FIRST = static_cast<size_t>(std::strtoul(pos, &end, 10));
+			size_t last = FIRST;
+
+			if (end == pos)
+				break;
+			if (*end == '-')
+				last = static_cast<size_t>(std::strtoul(end + 1, &end, 10));
+
+			for (size_t i = FIRST; i <= last; ++i)
+				cpus.push_back(i);
+
+			pos = (*end == ',') ? end + 1 : end;
+		}
+
+		return cpus;
+	}
+
+	bool CpuDetect::ReadTopology()
+	{
+		m_processors.clear();
+
+#if defined(CEX_OS_WINDOWS)
+		DWORD length = 0;
+		GetLogicalProcessorInformationEx(RelationAll, 0, &length);
+
+		if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || length == 0)
+			return false;
+
+		std::vector<byte> buffer(length);
+
+		if (!GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&buffer[0]), &length))
+			return false;
+
+		// cores and packages are separate records; the affinity functions address the first processor group only
+		const size_t MAXCPU = sizeof(KAFFINITY) * 8;
+		std::vector<ProcessorInfo> procs(MAXCPU);
+		std::vector<int> effClass(MAXCPU, -1);
+		size_t coreCtr = 0;
+		size_t pkgCtr = 0;
+		int maxClass = 0;
+
+		for (DWORD pos = 0; pos < length;)
+		{
+			PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX info = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(&buffer[pos]);
+
+			if (info->Relationship == RelationProcessorCore && info->Processor.GroupMask[0].Group == 0)
+			{
+				const KAFFINITY MASK = info->Processor.GroupMask[0].Mask;
+				size_t thread = 0;
+
+				for (size_t i = 0; i < MAXCPU; ++i)
+				{
+					if ((MASK >> i) & 1)
+					{
+						procs[i].Cpu = i;
+						procs[i].Core = coreCtr;
+						procs[i].Thread = thread++;
+						effClass[i] = info->Processor.EfficiencyClass;
+					}
+				}
+
+				maxClass = (std::max)(maxClass, static_cast<int>(info->Processor.EfficiencyClass));
+				++coreCtr;
+			}
+			else if (info->Relationship == RelationProcessorPackage)
+			{
+				for (WORD g = 0; g < info->Processor.GroupCount; ++g)
+				{
+					if (info->Processor.GroupMask[g].Group != 0)
+						continue;
+
+					for (size_t i = 0; i < MAXCPU; ++i)
+					{
+						if ((info->Processor.GroupMask[g].Mask >> i) & 1)
+							procs[i].Package = pkgCtr;
+					}
+				}
+
+				++pkgCtr;
+			}
+
+			pos += info->Size;
+		}
+
+		// the efficiency class is zero on every core of a processor that is not hybrid, and highest on the performance cores
+		for (size_t i = 0; i < MAXCPU; ++i)
+		{
+			if (effClass[i] < 0)
+				continue;
+
+			procs[i].Type = (maxClass == 0) ? CoreTypes::Unknown : (effClass[i] == maxClass) ? CoreTypes::Performance : CoreTypes::Efficient;
+			m_processors.push_back(procs[i]);
+		}
+#elif defined(CEX_OS_LINUX)
+		const std::string ROOT = "/sys/devices/system/cpu/";
+		std::string list;
+
+		if (!(std::ifstream(ROOT + "online") >> list))
+			return false;
+
+		const std::vector<size_t> CPUS = ParseCpuList(list);
+		std::vector<size_t> perfCpus;
+		std::vector<size_t> effCpus;
+
+		// the hybrid pmus list the processors of each core type
+		list.clear();
+		if (std::ifstream("/sys/devices/cpu_core/cpus") >> list)
+			perfCpus = ParseCpuList(list);
+		list.clear();
+		if (std::ifstream("/sys/devices/cpu_atom/cpus") >> list)
+			effCpus = ParseCpuList(list);
+
+		for (size_t i = 0; i < CPUS.size(); ++i)
+		{
+			const std::string DIR = ROOT + "cpu" + std::to_string(CPUS[i]) + "/topology/";
+			ProcessorInfo info;
+			std::string siblings;
+
+			info.Cpu = CPUS[i];
+			info.Thread = 0;
+			info.Type = CoreTypes::Unknown;
+
+			if (!(std::ifstream(DIR + "physical_package_id") >> info.Package) || !(std::ifstream(DIR + "core_id") >> info.Core) || !(std::ifstream(DIR + "thread_siblings_list") >> siblings))
+			{
+				m_processors.clear();
+				return false;
+			}
+
+			const std::vector<size_t> SIBLINGS = ParseCpuList(siblings);
+			info.Thread = static_cast<size_t>(std::find(SIBLINGS.begin(), SIBLINGS.end(), info.Cpu) - SIBLINGS.begin());
+
+			if (info.Thread == SIBLINGS.size())
+				info.Thread = 0;
+
+			if (std::find(perfCpus.begin(), perfCpus.end(), info.Cpu) != perfCpus.end())
+				info.Type = CoreTypes::Performance;
+			else if (std::find(effCpus.begin(), effCpus.end(), info.Cpu) != effCpus.end())
+				info.Type = CoreTypes::Efficient;
+
+			m_processors.push_back(info);
+		}
+
+		// without the pmu lists, the hybrid information leaf is read on each processor in turn
+		if (m_hybrid && perfCpus.empty() && effCpus.empty())
+		{
+			int cpuInfo[4];
+			cpuid(cpuInfo, 0);
+
+			cpu_set_t oldSet;
+			CPU_ZERO(&oldSet);
+
+			if (cpuInfo[0] >= 0x1A && sched_getaffinity(0, sizeof(cpu_set_t), &oldSet) == 0)
+			{
+				for (size_t i = 0; i < m_processors.size(); ++i)
+				{
+					cpu_set_t cpuSet;
+					CPU_ZERO(&cpuSet);
+					CPU_SET(m_processors[i].Cpu, &cpuSet);
+
+					if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) != 0)
+						continue;
+
+					cpuid(cpuInfo, 0x1A);
+					const uint32_t CORTYP = READBITSFROM(cpuInfo[0], 24, 8);
+
+					if (CORTYP == 0x40)
+						m_processors[i].Type = CoreTypes::Performance;
+					else if (CORTYP == 0x20)
+						m_processors[i].Type = CoreTypes::Efficient;
+				}
+
+				sched_setaffinity(0, sizeof(cpu_set_t), &oldSet);
+			}
+		}
+#endif
 
-		// TODO:
-		//http://www.cyberciti.biz/faq/linux-cpuid-command-read-cpuid-instruction-on-linux-for-cpu/
-		/*L3 cache information(0x80000006 / edx) :
-		line size(bytes) = 0x0 (0)
-		lines per tag = 0x0 (0)
-		associativity = L2 off(0)
-		size(in 512Kb units) = 0x0 (0)*/
+		return m_processors.size() != 0;
 	}
 
 	size_t CpuDetect::MaxCoresPerPackage()
@@ -209,13 +722,33 @@ namespace CpuJitter
 		int cpuInfo[4];
 		cpuid(cpuInfo, 0);
 
-		if (cpuInfo[0] >= 0x16)
+		const int MAXLEAF = cpuInfo[0];
+
+		if (MAXLEAF >= 0x16)
 		{
 			cpuid(cpuInfo, 0x16);
 			m_frequencyBase = cpuInfo[0];
 			m_frequencyMax = cpuInfo[1];
 			m_busSpeed = cpuInfo[2];
 		}
+
+		// the tsc runs at the crystal clock times the ratio EBX/EAX; the crystal clock in ECX is zero on some processors,
+		// which then report the base frequency in leaf 0x16, itself the crystal clock times the same ratio
+		if (MAXLEAF >= 0x15)
+		{
+			cpuid(cpuInfo, 0x15);
+			const uint64_t DENOM = static_cast<uint32_t>(cpuInfo[0]);
+			const uint64_t NUMER = static_cast<uint32_t>(cpuInfo[1]);
+			const uint64_t CRYSTAL = static_cast<uint32_t>(cpuInfo[2]);
+
+			if (DENOM != 0 && NUMER != 0)
+			{
+				if (CRYSTAL != 0)
+					m_tscFrequency = CRYSTAL * NUMER / DENOM;
+				else if (m_frequencyBase != 0)
+					m_tscFrequency = static_cast<uint64_t>(m_frequencyBase) * 1000000ULL;
+			}
+		}
 	}
 	void CpuDetect::GetSerialNumber()
 	{
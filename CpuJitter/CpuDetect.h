@@ -2,26 +2,33 @@
 #define _CEXENGINE_CPUDETECT_H
 
 #include <algorithm>
+#include <memory>
 #include "Config.h"
 
 #if defined(CEX_OS_WINDOWS)
 #	include <intrin.h>
 #	include <stdio.h>
 #	define cpuid(info, x)  __cpuidex(info, x, 0)
+#	define cpuidex(info, x, y)  __cpuidex(info, x, y)
 #	if defined(_MSC_VER) && _MSC_FULL_VER >= 160040219
 #		define MSCAVX
 #	endif
 #else
 #	include <cpuid.h>
-	void cpuid(int info[4], int InfoType) {
+	inline void cpuid(int info[4], int InfoType) {
 		__cpuid_count(InfoType, 0, info[0], info[1], info[2], info[3]);
 	}
+	inline void cpuidex(int info[4], int InfoType, int SubLeaf) {
+		__cpuid_count(InfoType, SubLeaf, info[0], info[1], info[2], info[3]);
+	}
 #endif
 
 namespace CpuJitter
 {
 	/// <summary>
-	/// Detects Cpu features and capabilities
+	/// Detects Cpu features and capabilities.
+	/// <para>Every instance executes the cpuid leaves again, which is slow under virtualization where cpuid traps to the hypervisor;
+	/// library code reads the process-wide Snapshot instead, which is detected once and shared. An instance has no mutating methods, so a snapshot never changes once published.</para>
 	/// </summary>
 	class CpuDetect
 	{
@@ -51,6 +58,97 @@ namespace CpuJitter
 			FullyAssociative = 16
 		};
 
+		/// <summary>
+		/// The core type of a logical processor on a hybrid processor
+		/// </summary>
+		enum class CoreTypes : int
+		{
+			/// <summary>
+			/// Not a hybrid processor, or the type is not reported
+			/// </summary>
+			Unknown = 0,
+			/// <summary>
+			/// A performance core
+			/// </summary>
+			Performance = 1,
+			/// <summary>
+			/// An efficient core
+			/// </summary>
+			Efficient = 2
+		};
+
+		/// <summary>
+		/// The kind of data held by a cache; the values are those of the cpuid cache parameter leaves
+		/// </summary>
+		enum class CacheTypes : int
+		{
+			Data = 1,
+			Instruction = 2,
+			Unified = 3
+		};
+
+		/// <summary>
+		/// The parameters of one cache of the hierarchy
+		/// </summary>
+		struct CacheInfo
+		{
+			/// <summary>
+			/// The cache level, 1 to 3
+			/// </summary>
+			uint32_t Level;
+			/// <summary>
+			/// The kind of data held by the cache
+			/// </summary>
+			CacheTypes Type;
+			/// <summary>
+			/// The capacity in bytes
+			/// </summary>
+			size_t Size;
+			/// <summary>
+			/// The line size in bytes
+			/// </summary>
+			size_t LineSize;
+			/// <summary>
+			/// The number of ways; zero if the cache is fully associative or the associativity is not reported
+			/// </summary>
+			size_t Ways;
+			/// <summary>
+			/// The number of sets; zero if not reported
+			/// </summary>
+			size_t Sets;
+			/// <summary>
+			/// The number of logical processors sharing the cache; zero if not reported
+			/// </summary>
+			size_t SharedBy;
+		};
+
+		/// <summary>
+		/// The position of one logical processor in the processor topology
+		/// </summary>
+		struct ProcessorInfo
+		{
+			/// <summary>
+			/// The operating system's index of the logical processor, as used by the affinity functions
+			/// </summary>
+			size_t Cpu;
+			/// <summary>
+			/// The physical package (socket)
+			/// </summary>
+			size_t Package;
+			/// <summary>
+			/// The physical core; unique within the package
+			/// </summary>
+			size_t Core;
+			/// <summary>
+			/// The position of the processor among the SMT siblings of its core; zero for the first thread of every core
+			/// </summary>
+			size_t Thread;
+			/// <summary>
+			/// The core type on a hybrid processor
+			/// </summary>
+			CoreTypes Type;
+		};
+
 	private:
 
 		static constexpr size_t KB1 = 1024;
@@ -82,13 +180,16 @@ namespace CpuJitter
 		bool m_bmt1;
 		bool m_bmt2;
 		uint32_t m_busSpeed;
+		std::vector<CacheInfo> m_caches;
 		std::string m_cpuVendor;
 		bool m_fma3;
 		bool m_fma4;
 		uint32_t m_frequencyBase;
 		uint32_t m_frequencyMax;
 		bool m_hle;
+		bool m_hybrid;
 		bool m_hyperThread;
+		bool m_invariantTsc;
 		size_t m_l1CacheSize;
 		size_t m_l1CacheLineSize;
 		CacheAssociations m_l2Associative;
@@ -96,12 +197,14 @@ namespace CpuJitter
 		size_t m_logicalPerCore;
 		bool m_mmx;
 		bool m_mpx;
+		bool m_pclmul;
 		size_t m_physCores;
 		bool m_pku;
 		bool m_pkuos;
 		bool m_pqe;
 		bool m_pqm;
 		bool m_prefetch;
+		std::vector<ProcessorInfo> m_processors;
 		bool m_rdRand;
 		bool m_rdSeed;
 		bool m_rtm;
@@ -118,6 +221,7 @@ namespace CpuJitter
 		bool m_sse4a;
 		bool m_sse41;
 		bool m_sse42;
+		uint64_t m_tscFrequency;
 		size_t m_virtCores;
 		bool m_x64;
 		bool m_xop;
@@ -249,6 +353,13 @@ namespace CpuJitter
 			return m_busSpeed;
 		}
 
+		/// <summary>
+		/// The cache hierarchy as seen from the first logical processor, in the order enumerated; empty if neither the operating system nor cpuid describe it.
+		/// <para>On Linux the kernel's description in /sys/devices/system/cpu/cpu0/cache is used, otherwise cpuid leaf 4 on Intel or leaf 0x8000001D on AMD,
+		/// with the legacy AMD leaves 0x80000005 and 0x80000006 as the last resort.</para>
+		/// </summary>
+		const std::vector<CacheInfo> Caches() { return m_caches; }
+
 		/// <summary>
 		/// AMD FMA 3 instructions available
 		/// </summary>
@@ -280,11 +391,21 @@ namespace CpuJitter
 		/// </summary>
 		const bool HLE() { return m_hle; }
 
+		/// <summary>
+		/// A hybrid processor with performance and efficient cores
+		/// </summary>
+		const bool Hybrid() { return m_hybrid; }
+
 		/// <summary>
 		/// Hardware supports hyper-threading
 		/// </summary>
 		const bool HyperThread() { return m_hyperThread; }
 
+		/// <summary>
+		/// The time stamp counter runs at a constant rate in every power and performance state and does not stop in deep sleep states (cpuid 0x80000007)
+		/// </summary>
+		const bool InvariantTSC() { return m_invariantTsc; }
+
 		/// <summary>
 		/// Cpu is x64
 		/// </summary>
@@ -306,7 +427,7 @@ namespace CpuJitter
 		/// </summary>
 		const size_t L1CacheLineSize()
 		{
-			if (m_l1CacheLineSize == 0 || m_l1CacheLineSize == 0)
+			if (m_l1CacheLineSize == 0)
 				return 64;
 			else
 				return m_l1CacheLineSize;
@@ -356,6 +477,11 @@ namespace CpuJitter
 				return m_l2CacheSize * m_physCores * KB1;
 		}
 
+		/// <summary>
+		/// The L3 cache size in bytes, shared by CacheInfo::SharedBy logical processors; zero if the processor has no L3 or it is not reported
+		/// </summary>
+		const size_t L3CacheSize() { return DataCache(3).Size; }
+
 		/// <summary>
 		/// Returns the L2 cache associativity
 		/// </summary>
@@ -377,10 +503,23 @@ namespace CpuJitter
 		const bool MPX() { return m_mpx; }
 
 		/// <summary>
-		/// The total number of physical processor cores
+		/// PCLMULQDQ carry-less multiplication instruction
+		/// </summary>
+		const bool PCLMUL() { return m_pclmul; }
+
+		/// <summary>
+		/// The total number of physical processor cores; counted from Processors when the topology is enumerated, otherwise estimated from cpuid
 		/// </summary>
 		const size_t PhysicalCores() { return m_physCores; }
 
+		/// <summary>
+		/// Every online logical processor with its package, core, SMT sibling position and core type, ordered by processor index; empty if the operating system does not describe the topology.
+		/// <para>On Linux the topology is read from /sys/devices/system/cpu, and the core types from the cpu_core and cpu_atom PMU lists or, without them, from cpuid leaf 0x1A on each processor.
+		/// On Windows it is read from GetLogicalProcessorInformationEx, using the efficiency class of each core; only the first processor group is enumerated.
+		/// The list is fixed when the processor is detected; see AllowedProcessors for the processors the calling thread may run on.</para>
+		/// </summary>
+		const std::vector<ProcessorInfo> Processors() { return m_processors; }
+
 		/// <summary>
 		/// Memory Protection Keys for User-mode pages
 		/// </summary>
@@ -491,6 +630,12 @@ namespace CpuJitter
 		/// </summary>
 		const bool SSE42() { return m_sse42; }
 
+		/// <summary>
+		/// The time stamp counter frequency in Hz from cpuid leaf 0x15; the crystal clock is derived from the leaf 0x16 base frequency when leaf 0x15 does not report it.
+		/// <para>Zero if the processor does not report the ratio, see HighResTimer::TscFrequency for a calibrated value.</para>
+		/// </summary>
+		const uint64_t TscFrequency() { return m_tscFrequency; }
+
 		/// <summary>
 		/// Returns the cpu vendors enumeration value
 		/// </summary>
@@ -500,16 +645,21 @@ namespace CpuJitter
 			{
 				std::string data = m_cpuVendor;
 				std::transform(data.begin(), data.end(), data.begin(), ::tolower);
-				if (m_cpuVendor.find_first_of("intel") > 0)
+				if (data.find("intel") != std::string::npos)
 					return CpuVendors::INTEL;
-				else if (m_cpuVendor.find_first_of("amd") > 0)
+				else if (data.find("amd") != std::string::npos)
 					return CpuVendors::AMD;
 			}
 			return CpuVendors::UNKNOWN;
 		}
 
 		/// <summary>
-		/// The total number of threads available using hyperthreading
+		/// The vendor identification string returned by cpuid, e.g. GenuineIntel or AuthenticAMD
+		/// </summary>
+		const std::string VendorName() { return m_cpuVendor; }
+
+		/// <summary>
+		/// The total number of threads available using hyperthreading; counted from Processors when the topology is enumerated, otherwise estimated from cpuid
 		/// </summary>
 		const size_t VirtualCores() { return m_virtCores; }
 
@@ -549,13 +699,16 @@ namespace CpuJitter
 			m_bmt1(false),
 			m_bmt2(false),
 			m_busSpeed(0),
+			m_caches(0),
 			m_cpuVendor(""),
 			m_fma3(false),
 			m_fma4(false),
 			m_frequencyBase(0),
 			m_frequencyMax(0),
 			m_hle(false),
+			m_hybrid(false),
 			m_hyperThread(false),
+			m_invariantTsc(false),
 			m_l1CacheSize(0),
 			m_l1CacheLineSize(0),
 			m_l2Associative(CacheAssociations::Disabled),
@@ -563,12 +716,14 @@ namespace CpuJitter
 			m_logicalPerCore(0),
 			m_mmx(false),
 			m_mpx(false),
+			m_pclmul(false),
 			m_physCores(0),
 			m_pku(false),
 			m_pkuos(false),
 			m_pqe(false),
 			m_pqm(false),
 			m_prefetch(false),
+			m_processors(0),
 			m_rdRand(false),
 			m_rdSeed(false),
 			m_rdtscp(false),
@@ -585,6 +740,7 @@ namespace CpuJitter
 			m_sse42(false),
 			m_sse4a(false),
 			m_ssse3(false),
+			m_tscFrequency(0),
 			m_virtCores(0),
 			m_x64(false),
 			m_xop(false)
@@ -592,6 +748,36 @@ namespace CpuJitter
 			Detect();
 		}
 
+		//~~~ Public Methods~~~//
+
+		/// <summary>
+		/// The logical processors in the calling thread's current affinity mask; read from the operating system on every call
+		/// </summary>
+		///
+		/// <returns>The processor indices in ascending order; empty if the operating system does not report the mask</returns>
+		static std::vector<size_t> AllowedProcessors();
+
+		/// <summary>
+		/// The data or unified cache of a level
+		/// </summary>
+		///
+		/// <param name="Level">The cache level, 1 to 3</param>
+		///
+		/// <returns>The cache parameters; all zero if the level is not enumerated</returns>
+		CacheInfo DataCache(uint32_t Level);
+
+		/// <summary>
+		/// Detect the processor again and publish the result as the new process-wide snapshot; holders of the previous snapshot keep it unchanged
+		/// </summary>
+		static void Refresh();
+
+		/// <summary>
+		/// The process-wide processor snapshot; detected by the first call and shared by every later call, thread safe
+		/// </summary>
+		///
+		/// <returns>The current snapshot</returns>
+		static std::shared_ptr<CpuDetect> Snapshot();
+
 	private:
 
 #if defined(MSCAVX)
@@ -599,6 +785,13 @@ namespace CpuJitter
 		bool Avx2Supported();
 #endif
 		void Detect();
+		void DetectCaches(uint32_t MaxLeaf, uint32_t MaxExtLeaf);
+		static size_t LegacyWays(uint32_t Association);
+		static std::vector<size_t> ParseCpuList(const std::string &List);
+		bool ReadCacheLeaf(uint32_t Leaf);
+		void ReadCacheLegacy(uint32_t MaxExtLeaf);
+		bool ReadCacheSysfs();
+		bool ReadTopology();
 		void GetFrequency();
 		void GetSerialNumber();
 		size_t MaxCoresPerPackage();
@@ -0,0 +1,119 @@
+#include "EntropyEstimator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace CpuJitter
+{
+	namespace
+	{
+		// the two sided 99% normal quantile used by the confidence bounds of SP 800-90B
+		const double NORMAL_Z99 = 2.576;
+		// the length of the most likely sequence in the Markov estimate
+		const size_t MARKOV_LENGTH = 128;
+
+		inline double Log2(double Value)
+		{
+			return (Value > 0.0) ? std::log2(Value) : -std::numeric_limits<double>::infinity();
+		}
+	}
+
+	//~~~Public Methods~~~//
+
+	EntropyEstimate EntropyEstimator::Estimate()
+	{
+		EntropyEstimate est = { 0.0, 0.0, 0.0, 0.0, m_samples, 0.0 };
+
+		if (m_samples < 2)
+			return est;
+
+		const size_t BITMAX = (std::max)(static_cast<size_t>(m_bitOnes), m_samples - m_bitOnes);
+
+		est.BitMcv = McvEntropy(BITMAX, m_samples);
+		est.Collision = CollisionEntropy();
+		est.Markov = MarkovEntropy();
+		est.MinEntropy = (std::min)(est.BitMcv, (std::min)(est.Collision, est.Markov));
+		est.SymbolMcv = McvEntropy(m_maxCount, m_samples);
+
+		return est;
+	}
+
+	void EntropyEstimator::Reset()
+	{
+		std::fill(m_frequency.begin(), m_frequency.end(), static_cast<uint16_t>(0));
+		std::fill(m_symbolCounts.begin(), m_symbolCounts.end(), static_cast<uint16_t>(0));
+		std::fill(m_window.begin(), m_window.end(), static_cast<uint16_t>(0));
+		std::fill(m_markov, m_markov + 4, 0);
+
+		// every symbol starts with a count of zero
+		m_frequency[0] = static_cast<uint16_t>(SYMBOL_COUNT);
+		m_bitOnes = 0;
+		m_colFirst = 0;
+		m_colLength2 = 0;
+		m_colLength3 = 0;
+		m_colPending = 0;
+		m_lastBit = 0;
+		m_maxCount = 0;
+		m_position = 0;
+		m_samples = 0;
+	}
+
+	//~~~Private Methods~~~//
+
+	double EntropyEstimator::CollisionEntropy()
+	{
+		// SP 800-90B 6.3.2; the lower bound of the mean tuple length is solved for the probability of the more likely bit.
+		// for binary samples the mean length is 2 + 2p(1 - p), so the binary search of the standard reduces to the root of a quadratic
+		const double TPLCNT = static_cast<double>(m_colLength2) + m_colLength3;
+
+		if (TPLCNT < 2.0)
+			return 0.0;
+
+		const double MEAN = (2.0 * m_colLength2 + 3.0 * m_colLength3) / TPLCNT;
+		const double VAR = (std::max)(0.0, (4.0 * m_colLength2 + 9.0 * m_colLength3 - TPLCNT * MEAN * MEAN) / (TPLCNT - 1.0));
+		const double MEANLOW = MEAN - NORMAL_Z99 * std::sqrt(VAR) / std::sqrt(TPLCNT);
+
+		// no solution; the mean is at or above that of an unbiased bit
+		if (MEANLOW >= 2.5)
+			return 1.0;
+
+		if (MEANLOW <= 2.0)
+			return 0.0;
+
+		const double PMAX = (1.0 + std::sqrt(1.0 - 2.0 * (MEANLOW - 2.0))) / 2.0;
+
+		return -std::log2(PMAX);
+	}
+
+	double EntropyEstimator::MarkovEntropy()
+	{
+		// SP 800-90B 6.3.3; the probability of the most likely 128 bit sequence under a first order model, taken in the log domain to avoid underflow
+		const double ROW0 = static_cast<double>(m_markov[0]) + m_markov[1];
+		const double ROW1 = static_cast<double>(m_markov[2]) + m_markov[3];
+		const double LP0 = Log2(static_cast<double>(m_samples - m_bitOnes) / m_samples);
+		const double LP1 = Log2(static_cast<double>(m_bitOnes) / m_samples);
+		const double LP00 = (ROW0 > 0.0) ? Log2(m_markov[0] / ROW0) : Log2(0.0);
+		const double LP01 = (ROW0 > 0.0) ? Log2(m_markov[1] / ROW0) : Log2(0.0);
+		const double LP10 = (ROW1 > 0.0) ? Log2(m_markov[2] / ROW1) : Log2(0.0);
+		const double LP11 = (ROW1 > 0.0) ? Log2(m_markov[3] / ROW1) : Log2(0.0);
+		const double SEQLEN = static_cast<double>(MARKOV_LENGTH);
+
+		double lmax = LP0 + (SEQLEN - 1.0) * LP00;
+		lmax = (std::max)(lmax, LP0 + (SEQLEN / 2.0) * LP01 + (SEQLEN / 2.0 - 1.0) * LP10);
+		lmax = (std::max)(lmax, LP0 + LP01 + (SEQLEN - 2.0) * LP11);
+		lmax = (std::max)(lmax, LP1 + LP10 + (SEQLEN - 2.0) * LP00);
+		lmax = (std::max)(lmax, LP1 + (SEQLEN / 2.0) * LP10 + (SEQLEN / 2.0 - 1.0) * LP01);
+		lmax = (std::max)(lmax, LP1 + (SEQLEN - 1.0) * LP11);
+
+		return (std::max)(0.0, (std::min)(1.0, -lmax / SEQLEN));
+	}
+
+	double EntropyEstimator::McvEntropy(size_t Count, size_t Samples)
+	{
+		// SP 800-90B 6.3.1; the upper bound of the 99% confidence interval of the most common value probability
+		const double PMAX = static_cast<double>(Count) / Samples;
+		const double PUPR = (std::min)(1.0, PMAX + NORMAL_Z99 * std::sqrt(PMAX * (1.0 - PMAX) / (Samples - 1)));
+
+		return (std::max)(0.0, -std::log2(PUPR));
+	}
+}
@@ -0,0 +1,239 @@
+#ifndef _CEXENGINE_ENTROPYESTIMATOR_H
+#define _CEXENGINE_ENTROPYESTIMATOR_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// A snapshot of the min-entropy estimates over the current sample window
+	/// </summary>
+	struct EntropyEstimate
+	{
+		/// <summary>
+		/// The most common value estimate (SP 800-90B 6.3.1) of the folded bit, in bits per measurement
+		/// </summary>
+		double BitMcv;
+		/// <summary>
+		/// The collision estimate (SP 800-90B 6.3.2) of the folded bit, in bits per measurement
+		/// </summary>
+		double Collision;
+		/// <summary>
+		/// The Markov estimate (SP 800-90B 6.3.3) of the folded bit, in bits per measurement
+		/// </summary>
+		double Markov;
+		/// <summary>
+		/// The smallest of the folded bit estimates; the min-entropy of the bit credited in the default mode, 0 to 1
+		/// </summary>
+		double MinEntropy;
+		/// <summary>
+		/// The number of measurements in the window the estimates were taken over
+		/// </summary>
+		size_t Samples;
+		/// <summary>
+		/// The most common value estimate of the eight bit fold used by harvest mode, in bits per measurement, 0 to 8
+		/// </summary>
+		double SymbolMcv;
+	};
+
+	/// <summary>
+	/// A streaming min-entropy estimator over a sliding window of raw timing deltas.
+	/// <para>Each delta is folded into the eight bit symbol mixed by harvest mode, and into the single bit (the parity of the delta) mixed by the default mode.
+	/// The most common value, collision and Markov statistics of NIST SP 800-90B are kept as counters that are updated as a sample enters the window and the oldest sample leaves it,
+	/// so a sample costs a constant number of counter updates and the memory is fixed by the window size. The estimates are only computed from the counters when queried.</para>
+	/// <para>The confidence bounds are those of a single window, so the estimates are conservative; the collision estimate of an ideal bit source is near 0.7 at this window size.</para>
+	/// </summary>
+	class EntropyEstimator
+	{
+	public:
+
+		/// <summary>
+		/// The number of measurements in the sliding window
+		/// </summary>
+		static const size_t WINDOW = 4096;
+
+	private:
+		static const size_t SYMBOL_COUNT = 256;
+		static const uint16_t SYMBOL_MASK = 0xFF;
+		static const size_t TUPLE_SHIFT = 8;
+
+		uint32_t m_bitOnes;
+		uint32_t m_colFirst;
+		uint32_t m_colLength2;
+		uint32_t m_colLength3;
+		uint32_t m_colPending;
+		std::vector<uint16_t> m_frequency;
+		uint32_t m_lastBit;
+		uint32_t m_markov[4];
+		uint32_t m_maxCount;
+		size_t m_position;
+		size_t m_samples;
+		std::vector<uint16_t> m_symbolCounts;
+		std::vector<uint16_t> m_window;
+
+	public:
+
+		EntropyEstimator(const EntropyEstimator&) = delete;
+		EntropyEstimator& operator=(const EntropyEstimator&) = delete;
+		EntropyEstimator& operator=(EntropyEstimator&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The window is full; estimates taken before this are over fewer than WINDOW measurements and have wider confidence bounds
+		/// </summary>
+		const bool Ready() { return m_samples == WINDOW; }
+
+		/// <summary>
+		/// Get: The number of measurements in the window
+		/// </summary>
+		const size_t Samples() { return m_samples; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate an empty estimator
+		/// </summary>
+		EntropyEstimator()
+			:
+			m_bitOnes(0),
+			m_colFirst(0),
+			m_colLength2(0),
+			m_colLength3(0),
+			m_colPending(0),
+			m_frequency(WINDOW + 1, 0),
+			m_lastBit(0),
+			m_markov(),
+			m_maxCount(0),
+			m_position(0),
+			m_samples(0),
+			m_symbolCounts(SYMBOL_COUNT, 0),
+			m_window(WINDOW, 0)
+		{
+			Reset();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Compute the estimates over the current window
+		/// </summary>
+		///
+		/// <returns>The estimates; all zero while the window holds fewer than two measurements</returns>
+		EntropyEstimate Estimate();
+
+		/// <summary>
+		/// Empty the window
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Add the next raw timing delta to the window, evicting the oldest once the window is full
+		/// </summary>
+		///
+		/// <param name="Delta">The raw timing delta</param>
+		inline void Sample(uint64_t Delta)
+		{
+			// the eight bit fold of harvest mode, and its parity, the one bit fold of the default mode
+			uint64_t fld = Delta ^ (Delta >> 32);
+			fld ^= fld >> 16;
+			fld ^= fld >> 8;
+			const uint32_t SYMBOL = static_cast<uint32_t>(fld & SYMBOL_MASK);
+			const uint32_t BIT = Parity(SYMBOL);
+
+			if (m_samples == WINDOW)
+				Evict();
+			else
+				++m_samples;
+
+			// most common value; the count of counts lets the maximum follow a decrement without a scan
+			const uint32_t SYMCNT = m_symbolCounts[SYMBOL];
+			--m_frequency[SYMCNT];
+			++m_frequency[SYMCNT + 1];
+			m_symbolCounts[SYMBOL] = static_cast<uint16_t>(SYMCNT + 1);
+
+			if (SYMCNT + 1 > m_maxCount)
+				m_maxCount = SYMCNT + 1;
+
+			m_bitOnes += BIT;
+
+			// markov transition from the previous bit
+			if (m_samples > 1)
+				++m_markov[(m_lastBit << 1) | BIT];
+
+			m_lastBit = BIT;
+
+			// collision parse of the bit stream; a tuple ends on the first repeated value, after two or three bits,
+			// and its length is tagged on the sample that ends it so it leaves the statistics with that sample
+			uint32_t tuple = 0;
+
+			if (m_colPending == 0)
+			{
+				m_colFirst = BIT;
+				m_colPending = 1;
+			}
+			else if (m_colPending == 1 && BIT != m_colFirst)
+			{
+				m_colPending = 2;
+			}
+			else
+			{
+				tuple = m_colPending + 1;
+				m_colPending = 0;
+
+				if (tuple == 2)
+					++m_colLength2;
+				else
+					++m_colLength3;
+			}
+
+			m_window[m_position] = static_cast<uint16_t>(SYMBOL | (tuple << TUPLE_SHIFT));
+
+			if (++m_position == WINDOW)
+				m_position = 0;
+		}
+
+	private:
+
+		double CollisionEntropy();
+		double MarkovEntropy();
+		static double McvEntropy(size_t Count, size_t Samples);
+
+		inline void Evict()
+		{
+			// the oldest sample is at the write position, the pair it starts leaves the markov counts with it
+			const uint32_t OLDEST = m_window[m_position];
+			const uint32_t NEXT = m_window[(m_position + 1) % WINDOW];
+			const uint32_t SYMBOL = OLDEST & SYMBOL_MASK;
+			const uint32_t BIT = Parity(SYMBOL);
+			const uint32_t TUPLE = OLDEST >> TUPLE_SHIFT;
+			const uint32_t SYMCNT = m_symbolCounts[SYMBOL];
+
+			--m_frequency[SYMCNT];
+
+			if (SYMCNT == m_maxCount && m_frequency[SYMCNT] == 0)
+				--m_maxCount;
+
+			++m_frequency[SYMCNT - 1];
+			m_symbolCounts[SYMBOL] = static_cast<uint16_t>(SYMCNT - 1);
+			m_bitOnes -= BIT;
+			--m_markov[(BIT << 1) | Parity(NEXT & SYMBOL_MASK)];
+
+			if (TUPLE == 2)
+				--m_colLength2;
+			else if (TUPLE == 3)
+				--m_colLength3;
+		}
+
+		static inline uint32_t Parity(uint32_t Symbol)
+		{
+			Symbol ^= Symbol >> 4;
+			Symbol ^= Symbol >> 2;
+			Symbol ^= Symbol >> 1;
+
+			return Symbol & 1;
+		}
+	};
+
+}
+#endif
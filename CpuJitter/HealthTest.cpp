@@ -0,0 +1,72 @@
+#include "HealthTest.h"
+#include <cmath>
+
+namespace CpuJitter
+{
+	//~~~Public Methods~~~//
+
+	void HealthTest::Configure(uint32_t EntropyBits)
+	{
+		if (EntropyBits == 0)
+			EntropyBits = 1;
+		else if (EntropyBits > 32)
+			EntropyBits = 32;
+
+		if (EntropyBits == m_entropyBits)
+			return;
+
+		m_entropyBits = EntropyBits;
+
+		// SP 800-90B 4.4.1; C = 1 + ceil(-log2(alpha) / H)
+		m_rctCutoff = 1 + static_cast<uint32_t>((FALSE_POSITIVE_LOG2 + EntropyBits - 1) / EntropyBits);
+
+		// SP 800-90B 4.4.2; C = 1 + CRITBINOM(W, 2^-H, 1 - alpha), the smallest count whose upper binomial tail is at most alpha
+		const double PRB = std::pow(2.0, -static_cast<double>(EntropyBits));
+		const double ALPHA = std::pow(2.0, -static_cast<double>(FALSE_POSITIVE_LOG2));
+		const double LNPRB = std::log(PRB);
+		const double LNQRB = std::log1p(-PRB);
+		double cdf = 0.0;
+		size_t crit = 0;
+		// log C(W, k), updated per step; lgamma is not used because it writes the global signgam, and providers are constructed concurrently
+		double lnBinom = 0.0;
+
+		for (crit = 0; crit < APT_WINDOW; ++crit)
+		{
+			if (crit != 0)
+				lnBinom += std::log(static_cast<double>(APT_WINDOW - crit + 1)) - std::log(static_cast<double>(crit));
+
+			const double LNPMF = lnBinom + crit * LNPRB + (APT_WINDOW - crit) * LNQRB;
+			cdf += std::exp(LNPMF);
+
+			if (cdf >= 1.0 - ALPHA)
+				break;
+		}
+
+		m_aptCutoff = static_cast<uint32_t>(crit + 1);
+	}
+
+	const char* HealthTest::Name(HealthStatus Status)
+	{
+		switch (Status)
+		{
+			case HealthStatus::Ok:
+				return "Ok";
+			case HealthStatus::RepetitionFailure:
+				return "RepetitionFailure";
+			case HealthStatus::ProportionFailure:
+				return "ProportionFailure";
+			default:
+				return "Unknown";
+		}
+	}
+
+	void HealthTest::Reset()
+	{
+		m_aptBase = 0;
+		m_aptCount = 0;
+		m_aptHits = 0;
+		m_rctBase = 0;
+		m_rctCount = 0;
+		m_status = HealthStatus::Ok;
+	}
+}
@@ -0,0 +1,163 @@
+#ifndef _CEXENGINE_HEALTHTEST_H
+#define _CEXENGINE_HEALTHTEST_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The state of the continuous health tests
+	/// </summary>
+	enum class HealthStatus : int
+	{
+		/// <summary>
+		/// No test has failed
+		/// </summary>
+		Ok = 0,
+		/// <summary>
+		/// The Repetition Count Test failed; the same sample was repeated beyond the cutoff
+		/// </summary>
+		RepetitionFailure = 1,
+		/// <summary>
+		/// The Adaptive Proportion Test failed; one sample value occupied too much of a window
+		/// </summary>
+		ProportionFailure = 2
+	};
+
+	/// <summary>
+	/// The continuous health tests of NIST SP 800-90B section 4.4 over the raw noise samples.
+	/// <para>The Repetition Count Test detects a noise source that is stuck on one value, the Adaptive Proportion Test detects a large loss of entropy
+	/// by counting how often the first sample of each window recurs within that window. Both are incremental, a sample costs a compare and a counter update.
+	/// A failure is latched until Reset.</para>
+	/// </summary>
+	class HealthTest
+	{
+	public:
+
+		/// <summary>
+		/// The Adaptive Proportion Test window for non-binary samples
+		/// </summary>
+		static const size_t APT_WINDOW = 512;
+
+		/// <summary>
+		/// The false positive probability of each test is 2^-FALSE_POSITIVE_LOG2
+		/// </summary>
+		static const size_t FALSE_POSITIVE_LOG2 = 30;
+
+		/// <summary>
+		/// The number of samples that must pass the tests at startup before output is produced
+		/// </summary>
+		static const size_t STARTUP_SAMPLES = 1024;
+
+	private:
+
+		uint64_t m_aptBase;
+		uint32_t m_aptCount;
+		uint32_t m_aptCutoff;
+		uint32_t m_aptHits;
+		uint32_t m_entropyBits;
+		uint64_t m_rctBase;
+		uint32_t m_rctCount;
+		uint32_t m_rctCutoff;
+		HealthStatus m_status;
+
+	public:
+
+		HealthTest(const HealthTest&) = delete;
+		HealthTest& operator=(const HealthTest&) = delete;
+		HealthTest& operator=(HealthTest&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The Adaptive Proportion Test cutoff; a window fails when its first sample occurs this many times
+		/// </summary>
+		const uint32_t AptCutoff() { return m_aptCutoff; }
+
+		/// <summary>
+		/// Get: The Repetition Count Test cutoff; the test fails when a sample is seen this many times in a row
+		/// </summary>
+		const uint32_t RctCutoff() { return m_rctCutoff; }
+
+		/// <summary>
+		/// Get: The test state; anything other than HealthStatus::Ok means the noise source has failed
+		/// </summary>
+		const HealthStatus Status() { return m_status; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate the tests with the cutoffs for one bit of min-entropy per sample
+		/// </summary>
+		HealthTest()
+			:
+			m_aptBase(0),
+			m_aptCount(0),
+			m_aptCutoff(0),
+			m_aptHits(0),
+			m_entropyBits(0),
+			m_rctBase(0),
+			m_rctCount(0),
+			m_rctCutoff(0),
+			m_status(HealthStatus::Ok)
+		{
+			Configure(1);
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Set the cutoffs for the min-entropy credited to each sample; the current windows are kept
+		/// </summary>
+		///
+		/// <param name="EntropyBits">The credited min-entropy per sample in bits, 1 to 32</param>
+		void Configure(uint32_t EntropyBits);
+
+		/// <summary>
+		/// Get the display name of a test state
+		/// </summary>
+		static const char* Name(HealthStatus Status);
+
+		/// <summary>
+		/// Clear the failure state and restart both tests
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Run both tests on the next noise sample
+		/// </summary>
+		///
+		/// <param name="Value">The raw sample</param>
+		inline void Sample(uint64_t Value)
+		{
+			// repetition count test; the run length of identical samples
+			if (Value == m_rctBase)
+			{
+				if (++m_rctCount >= m_rctCutoff)
+					m_status = HealthStatus::RepetitionFailure;
+			}
+			else
+			{
+				m_rctBase = Value;
+				m_rctCount = 1;
+			}
+
+			// adaptive proportion test; the occurrences of the first sample of the window
+			if (m_aptCount == 0)
+			{
+				m_aptBase = Value;
+				m_aptHits = 1;
+			}
+			else if (Value == m_aptBase)
+			{
+				if (++m_aptHits >= m_aptCutoff)
+					m_status = HealthStatus::ProportionFailure;
+			}
+
+			if (++m_aptCount == APT_WINDOW)
+				m_aptCount = 0;
+		}
+	};
+
+}
+#endif
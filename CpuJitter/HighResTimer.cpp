@@ -0,0 +1,343 @@
+#include "HighResTimer.h"
+#include "CpuDetect.h"
+#include "PerfCounter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace CpuJitter
+{
+	//~~~Public Methods~~~//
+
+	std::vector<TimerSources> HighResTimer::Candidates()
+	{
+		std::vector<TimerSources> sources;
+		const TimerSources ALLSRC[] = { TimerSources::Default, TimerSources::Rdtsc, TimerSources::Rdtscp, TimerSources::LfenceRdtsc, TimerSources::ClockMonotonic, TimerSources::ClockMonotonicRaw, TimerSources::PerfCycles };
+
+		for (size_t i = 0; i < sizeof(ALLSRC) / sizeof(ALLSRC[0]); ++i)
+		{
+			if (Function(ALLSRC[i]) != 0)
+				sources.push_back(ALLSRC[i]);
+		}
+
+		return sources;
+	}
+
+	double HighResTimer::Cost(TimerSources Source)
+	{
+		const size_t READ_COUNT = 1000;
+		const size_t REPEAT_COUNT = 5;
+		TimerFunction func = Function(Source);
+
+		if (func == 0)
+			return 0.0;
+
+		// warm the code path, then keep the fastest of several runs to reject preemption and frequency transitions
+		volatile uint64_t sink = func();
+		double minCost = 0.0;
+
+		for (size_t i = 0; i < REPEAT_COUNT; ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			for (size_t j = 0; j < READ_COUNT; ++j)
+				sink ^= func();
+
+			auto elapsed = std::chrono::steady_clock::now() - start;
+			const double COST = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / READ_COUNT;
+
+			if (i == 0 || COST < minCost)
+				minCost = COST;
+		}
+
+		(void)sink;
+
+		return minCost;
+	}
+
+	HighResTimer::TimerFunction HighResTimer::Function(TimerSources Source)
+	{
+		switch (Source)
+		{
+			case TimerSources::Default:
+				return &HighResTimer::Default;
+#if defined(CEX_TIMER_TSC)
+			case TimerSources::Rdtsc:
+				return &HighResTimer::Rdtsc;
+			case TimerSources::Rdtscp:
+				return HasRdtscp() ? &HighResTimer::Rdtscp : 0;
+			case TimerSources::LfenceRdtsc:
+				return &HighResTimer::LfenceRdtsc;
+#endif
+#if defined(CEX_TIMER_POSIX) && defined(CLOCK_MONOTONIC)
+			case TimerSources::ClockMonotonic:
+				return &HighResTimer::ClockMonotonic;
+#endif
+#if defined(CEX_TIMER_POSIX) && defined(CLOCK_MONOTONIC_RAW)
+			case TimerSources::ClockMonotonicRaw:
+				return &HighResTimer::ClockMonotonicRaw;
+#endif
+#if defined(CEX_PERF_RDPMC)
+			case TimerSources::PerfCycles:
+				return PerfCounter::Available() ? &PerfCounter::Cycles : 0;
+#endif
+			default:
+				return 0;
+		}
+	}
+
+	const char* HighResTimer::Name(TimerSources Source)
+	{
+		switch (Source)
+		{
+			case TimerSources::Auto:
+				return "Auto";
+			case TimerSources::Default:
+				return "Default";
+			case TimerSources::Rdtsc:
+				return "RDTSC";
+			case TimerSources::Rdtscp:
+				return "RDTSCP";
+			case TimerSources::LfenceRdtsc:
+				return "LFENCE+RDTSC";
+			case TimerSources::ClockMonotonic:
+				return "CLOCK_MONOTONIC";
+			case TimerSources::ClockMonotonicRaw:
+				return "CLOCK_MONOTONIC_RAW";
+			case TimerSources::PerfCycles:
+				return "PERF_CYCLES";
+			default:
+				return "Unknown";
+		}
+	}
+
+	std::vector<TimerSources> HighResTimer::Ranked()
+	{
+		std::vector<TimerSources> sources = Candidates();
+		std::vector<std::pair<double, TimerSources>> ranked;
+
+		sources.erase(std::remove(sources.begin(), sources.end(), TimerSources::PerfCycles), sources.end());
+
+		for (size_t i = 0; i < sources.size(); ++i)
+			ranked.push_back(std::make_pair(Cost(sources[i]), sources[i]));
+
+		// a stable sort keeps the declaration order between sources of equal cost; a variant counter is only used when no clock qualifies
+		const bool VARTSC = !TscInvariant();
+
+		std::stable_sort(ranked.begin(), ranked.end(), [VARTSC](const std::pair<double, TimerSources> &A, const std::pair<double, TimerSources> &B)
+		{
+			if (VARTSC && IsCycleCounter(A.second) != IsCycleCounter(B.second))
+				return IsCycleCounter(B.second);
+
+			return A.first < B.first;
+		});
+
+		for (size_t i = 0; i < ranked.size(); ++i)
+			sources[i] = ranked[i].second;
+
+		return sources;
+	}
+
+	double HighResTimer::ToNanoseconds(uint64_t Ticks, TimerSources Source)
+	{
+		if (Source == TimerSources::PerfCycles)
+			return 0.0;
+
+		if (!IsCycleCounter(Source))
+			return static_cast<double>(Ticks);
+
+		const double TSCFRQ = TscFrequency();
+
+		return (TSCFRQ == 0.0) ? 0.0 : static_cast<double>(Ticks) * 1e9 / TSCFRQ;
+	}
+
+	double HighResTimer::TscFrequency()
+	{
+		// cached for the process; a concurrent first call only repeats the detection
+		static std::atomic<double> tscFreq(-1.0);
+		double freq = tscFreq.load(std::memory_order_acquire);
+
+		if (freq < 0.0)
+		{
+			try
+			{
+				freq = static_cast<double>(CpuDetect::Snapshot()->TscFrequency());
+			}
+			catch (...)
+			{
+				freq = 0.0;
+			}
+
+			if (freq == 0.0)
+				freq = CalibrateTsc();
+
+			tscFreq.store(freq, std::memory_order_release);
+		}
+
+		return freq;
+	}
+
+	bool HighResTimer::TscInvariant()
+	{
+#if defined(CEX_TIMER_TSC)
+		try
+		{
+			return CpuDetect::Snapshot()->InvariantTSC();
+		}
+		catch (...)
+		{
+			return false;
+		}
+#else
+		return false;
+#endif
+	}
+
+	uint64_t HighResTimer::Default()
+	{
+		// based on: http://nadeausoftware.com/articles/2012/04/c_c_tip_how_measure_elapsed_real_time_benchmarking
+
+#if defined(CEX_OS_WINDOWS) && defined(CEX_TIMER_TSC)
+
+		return static_cast<uint64_t>(__rdtsc());
+
+#elif (defined(CEX_OS_HPUX) || defined(CEX_OS_SUNUX)) && (defined(__SVR4) || defined(__svr4__))
+		// HP-UX, Solaris
+		return static_cast<uint64_t>(gethrtime());
+
+#elif defined(CEX_OS_APPLE)
+		// OSX
+		static double timeConvert = 0.0;
+		if (timeConvert == 0.0)
+		{
+			mach_timebase_info_data_t timeBase;
+			(void)mach_timebase_info(&timeBase);
+			timeConvert = static_cast<double>(timeBase.numer) / static_cast<double>(timeBase.denom);
+		}
+
+		return static_cast<uint64_t>(mach_absolute_time() * timeConvert);
+
+#elif defined(CEX_TIMER_POSIX)
+		// POSIX
+#	if defined(_POSIX_TIMERS) && (_POSIX_TIMERS > 0)
+		struct timespec ts;
+#		if defined(CLOCK_MONOTONIC_PRECISE)
+		// BSD
+		const clockid_t id = CLOCK_MONOTONIC_PRECISE;
+#		elif defined(CLOCK_MONOTONIC_RAW)
+		// Linux
+		const clockid_t id = CLOCK_MONOTONIC_RAW;
+#		elif defined(CLOCK_HIGHRES)
+		// Solaris
+		const clockid_t id = CLOCK_HIGHRES;
+#		elif defined(CLOCK_MONOTONIC)
+		// AIX, BSD, Linux, POSIX, Solaris
+		const clockid_t id = CLOCK_MONOTONIC;
+#		elif defined(CLOCK_REALTIME)
+		// AIX, BSD, HP-UX, Linux, POSIX
+		const clockid_t id = CLOCK_REALTIME;
+#		else
+		// Unknown
+		const clockid_t id = (clockid_t)-1;
+#		endif
+
+		if (id != (clockid_t)-1 && clock_gettime(id, &ts) != -1)
+			return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#	endif
+		// AIX, BSD, Cygwin, HP-UX, Linux, OSX, POSIX, Solaris
+		struct timeval tm;
+		gettimeofday(&tm, NULL);
+
+		return static_cast<uint64_t>(tm.tv_sec) * 1000000ULL + static_cast<uint64_t>(tm.tv_usec);
+
+#else
+		std::chrono::high_resolution_clock::time_point epoch;
+		auto now = std::chrono::high_resolution_clock::now();
+		auto elapsed = now - epoch;
+
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#endif
+	}
+
+	//~~~Private Methods~~~//
+
+	double HighResTimer::CalibrateTsc()
+	{
+#if defined(CEX_TIMER_TSC)
+		const size_t PAIRCNT = 5;
+		const int64_t CLBRNS = 20000000;
+
+		// each counter read is bracketed by two clock reads; the tightest of a few brackets dates it most precisely, at their midpoint
+		auto sample = [PAIRCNT](uint64_t &Ticks) -> double
+		{
+			double bestTime = 0.0;
+			int64_t bestSpan = -1;
+
+			for (size_t i = 0; i < PAIRCNT; ++i)
+			{
+				const auto CLK1 = std::chrono::steady_clock::now();
+				const uint64_t TSC = Rdtsc();
+				const auto CLK2 = std::chrono::steady_clock::now();
+				const int64_t NS1 = std::chrono::duration_cast<std::chrono::nanoseconds>(CLK1.time_since_epoch()).count();
+				const int64_t NS2 = std::chrono::duration_cast<std::chrono::nanoseconds>(CLK2.time_since_epoch()).count();
+
+				if (bestSpan < 0 || NS2 - NS1 < bestSpan)
+				{
+					bestSpan = NS2 - NS1;
+					bestTime = (static_cast<double>(NS1) + static_cast<double>(NS2)) / 2.0;
+					Ticks = TSC;
+				}
+			}
+
+			return bestTime;
+		};
+
+		uint64_t startTicks = 0;
+		uint64_t endTicks = 0;
+		const double STRTIME = sample(startTicks);
+		const auto DEADLINE = std::chrono::steady_clock::now() + std::chrono::nanoseconds(CLBRNS);
+
+		while (std::chrono::steady_clock::now() < DEADLINE)
+		{
+		}
+
+		const double ENDTIME = sample(endTicks);
+
+		if (ENDTIME <= STRTIME || endTicks <= startTicks)
+			return 0.0;
+
+		return static_cast<double>(endTicks - startTicks) * 1e9 / (ENDTIME - STRTIME);
+#else
+		return 0.0;
+#endif
+	}
+
+	bool HighResTimer::HasRdtscp()
+	{
+		try
+		{
+			return CpuDetect::Snapshot()->RDTSCP();
+		}
+		catch (...)
+		{
+			return false;
+		}
+	}
+
+	bool HighResTimer::IsCycleCounter(TimerSources Source)
+	{
+		switch (Source)
+		{
+			case TimerSources::Rdtsc:
+			case TimerSources::Rdtscp:
+			case TimerSources::LfenceRdtsc:
+				return true;
+#if defined(CEX_OS_WINDOWS) && defined(CEX_TIMER_TSC)
+			case TimerSources::Default:
+				return true;
+#endif
+			default:
+				return false;
+		}
+	}
+}
@@ -0,0 +1,223 @@
+#ifndef _CEXENGINE_HIGHRESTIMER_H
+#define _CEXENGINE_HIGHRESTIMER_H
+
+#include "Config.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#	define CEX_TIMER_TSC
+#	if defined(CEX_OS_WINDOWS)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#endif
+
+#if defined(CEX_OS_APPLE)
+#	include <mach/mach.h>
+#	include <mach/mach_time.h>
+#	include <time.h>
+#elif defined(CEX_OS_LINUX) || defined(CEX_OS_UNIX) || defined(CEX_OS_POSIX)
+#	define CEX_TIMER_POSIX
+#	include <sys/time.h>
+#	include <time.h>
+#	include <unistd.h>
+#endif
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The high resolution timestamp sources available to the jitter providers
+	/// </summary>
+	enum class TimerSources : int
+	{
+		/// <summary>
+		/// Benchmark the supported sources and select the cheapest one that qualifies
+		/// </summary>
+		Auto = 0,
+		/// <summary>
+		/// The platform default clock; rdtsc on windows, mach_absolute_time on apple, clock_gettime on posix
+		/// </summary>
+		Default = 1,
+		/// <summary>
+		/// The x86 time stamp counter read with RDTSC
+		/// </summary>
+		Rdtsc = 2,
+		/// <summary>
+		/// The x86 time stamp counter read with the partially serializing RDTSCP
+		/// </summary>
+		Rdtscp = 3,
+		/// <summary>
+		/// The x86 time stamp counter read with RDTSC behind an LFENCE
+		/// </summary>
+		LfenceRdtsc = 4,
+		/// <summary>
+		/// clock_gettime(CLOCK_MONOTONIC); served by the vDSO on linux without a system call
+		/// </summary>
+		ClockMonotonic = 5,
+		/// <summary>
+		/// clock_gettime(CLOCK_MONOTONIC_RAW); a system call on many linux kernels
+		/// </summary>
+		ClockMonotonicRaw = 6,
+		/// <summary>
+		/// The calling thread's core cycle counter, a perf_event read in user space with RDPMC; linux x86 only, and only where hardware perf events are permitted.
+		/// <para>Used only when requested; Auto does not rank it, see PerfCounter.</para>
+		/// </summary>
+		PerfCycles = 7
+	};
+
+	/// <summary>
+	/// High resolution timestamp sources with a micro-benchmark used to rank them
+	/// <para>The counter reads are defined inline so that providers specialized on a single source can inline the read into the measurement loop.</para>
+	/// </summary>
+	class HighResTimer
+	{
+	public:
+
+		/// <summary>
+		/// A timestamp read function
+		/// </summary>
+		typedef uint64_t(*TimerFunction)();
+
+		/// <summary>
+		/// Get the supported timestamp sources on this platform and processor, in declaration order
+		/// </summary>
+		///
+		/// <returns>The supported sources, not including Auto</returns>
+		static std::vector<TimerSources> Candidates();
+
+		/// <summary>
+		/// Measure the average cost of a single timestamp read
+		/// </summary>
+		///
+		/// <param name="Source">The timestamp source</param>
+		///
+		/// <returns>The average read cost in nanoseconds, or zero if the source is not supported</returns>
+		static double Cost(TimerSources Source);
+
+		/// <summary>
+		/// Get the read function of a timestamp source
+		/// </summary>
+		///
+		/// <param name="Source">The timestamp source</param>
+		///
+		/// <returns>The read function, or null if the source is not supported</returns>
+		static TimerFunction Function(TimerSources Source);
+
+		/// <summary>
+		/// Get the display name of a timestamp source
+		/// </summary>
+		static const char* Name(TimerSources Source);
+
+		/// <summary>
+		/// Get the supported timestamp sources ordered from the cheapest to the most expensive read.
+		/// <para>When the time stamp counter is not invariant its sources are ranked after the clock sources; their rate then follows the processor frequency, so the ticks have no fixed unit.
+		/// PerfCycles is not ranked; it holds a perf_event group open on every thread that reads it, so it is only used when requested.</para>
+		/// </summary>
+		///
+		/// <returns>The supported sources ranked by Cost</returns>
+		static std::vector<TimerSources> Ranked();
+
+		/// <summary>
+		/// Convert a tick count of a timestamp source to nanoseconds
+		/// </summary>
+		///
+		/// <param name="Ticks">The number of ticks</param>
+		/// <param name="Source">The timestamp source the ticks were read from</param>
+		///
+		/// <returns>The duration in nanoseconds; time stamp counter ticks are divided by TscFrequency, the clock sources already count nanoseconds. Zero for PerfCycles, whose core cycles have no fixed unit</returns>
+		static double ToNanoseconds(uint64_t Ticks, TimerSources Source);
+
+		/// <summary>
+		/// The time stamp counter frequency in Hz.
+		/// <para>Read from cpuid leaf 0x15 when the processor reports it, otherwise calibrated once against the monotonic clock over 20 milliseconds; the value is cached for the process.
+		/// Zero on processors without a time stamp counter.</para>
+		/// </summary>
+		static double TscFrequency();
+
+		/// <summary>
+		/// The time stamp counter is invariant; it ticks at TscFrequency in every power state, so its ticks can be converted to time
+		/// </summary>
+		static bool TscInvariant();
+
+		/// <summary>
+		/// The platform default clock
+		/// </summary>
+		static uint64_t Default();
+
+		/// <summary>
+		/// Read clock_gettime(CLOCK_MONOTONIC) in nanoseconds; returns zero if the clock is not supported
+		/// </summary>
+		static inline uint64_t ClockMonotonic()
+		{
+#if defined(CEX_TIMER_POSIX) && defined(CLOCK_MONOTONIC)
+			struct timespec ts;
+
+			if (clock_gettime(CLOCK_MONOTONIC, &ts) != -1)
+				return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+			return 0;
+		}
+
+		/// <summary>
+		/// Read clock_gettime(CLOCK_MONOTONIC_RAW) in nanoseconds; returns zero if the clock is not supported
+		/// </summary>
+		static inline uint64_t ClockMonotonicRaw()
+		{
+#if defined(CEX_TIMER_POSIX) && defined(CLOCK_MONOTONIC_RAW)
+			struct timespec ts;
+
+			if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) != -1)
+				return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+			return 0;
+		}
+
+		/// <summary>
+		/// Read the time stamp counter behind an LFENCE; returns zero on non x86 targets
+		/// </summary>
+		static inline uint64_t LfenceRdtsc()
+		{
+#if defined(CEX_TIMER_TSC)
+			// the fence keeps the counter read from being hoisted above earlier loads
+			_mm_lfence();
+			return static_cast<uint64_t>(__rdtsc());
+#else
+			return 0;
+#endif
+		}
+
+		/// <summary>
+		/// Read the time stamp counter; returns zero on non x86 targets
+		/// </summary>
+		static inline uint64_t Rdtsc()
+		{
+#if defined(CEX_TIMER_TSC)
+			return static_cast<uint64_t>(__rdtsc());
+#else
+			return 0;
+#endif
+		}
+
+		/// <summary>
+		/// Read the time stamp counter with RDTSCP; returns zero on non x86 targets.
+		/// <para>The caller must check that the processor supports the instruction, see Function.</para>
+		/// </summary>
+		static inline uint64_t Rdtscp()
+		{
+#if defined(CEX_TIMER_TSC)
+			unsigned int aux = 0;
+			return static_cast<uint64_t>(__rdtscp(&aux));
+#else
+			return 0;
+#endif
+		}
+
+	private:
+
+		static double CalibrateTsc();
+		static bool HasRdtscp();
+		static bool IsCycleCounter(TimerSources Source);
+	};
+
+}
+#endif
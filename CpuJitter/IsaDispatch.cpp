@@ -0,0 +1,149 @@
+#include "IsaDispatch.h"
+#include "CpuDetect.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__)
+#	define CEX_DISPATCH_X86
+#endif
+
+namespace CpuJitter
+{
+	namespace
+	{
+		// the xcr0 state components; sse and avx for the ymm registers, then opmask, zmm hi256 and hi16 zmm for avx-512
+		const uint64_t XCR0_YMM = 0x06;
+		const uint64_t XCR0_ZMM = 0xE6;
+
+#if defined(CEX_DISPATCH_X86)
+		uint64_t ReadXcr0()
+		{
+			// the os enables xgetbv with the xsave state; without OSXSAVE no extended register state is saved and the instruction faults
+			int cpuInfo[4];
+			cpuid(cpuInfo, 1);
+
+			if ((cpuInfo[2] & (1 << 27)) == 0)
+				return 0;
+#	if defined(CEX_OS_WINDOWS)
+			return static_cast<uint64_t>(_xgetbv(0));
+#	else
+			uint32_t high;
+			uint32_t low;
+
+			__asm__ __volatile__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+
+			return (static_cast<uint64_t>(high) << 32) | low;
+#	endif
+		}
+#endif
+	}
+
+	const char* IsaDispatch::ENVIRONMENT = "CEX_CJP_ISA";
+
+	//~~~Public Methods~~~//
+
+	IsaTiers IsaDispatch::Detected()
+	{
+#if defined(CEX_DISPATCH_X86)
+		try
+		{
+			std::shared_ptr<CpuDetect> detect = CpuDetect::Snapshot();
+			const uint64_t XCR0 = ReadXcr0();
+
+			if (detect->AVX512F() && detect->AVX512BW() && detect->AVX512VL() && (XCR0 & XCR0_ZMM) == XCR0_ZMM)
+				return IsaTiers::Avx512;
+			if (detect->AVX2() && (XCR0 & XCR0_YMM) == XCR0_YMM)
+				return IsaTiers::Avx2;
+			if (detect->SSE42())
+				return IsaTiers::Sse;
+		}
+		catch (...)
+		{
+		}
+#endif
+
+		return IsaTiers::Scalar;
+	}
+
+	const char* IsaDispatch::Name(IsaTiers Tier)
+	{
+		switch (Tier)
+		{
+			case IsaTiers::Scalar:
+				return "Scalar";
+			case IsaTiers::Sse:
+				return "SSE";
+			case IsaTiers::Avx2:
+				return "AVX2";
+			case IsaTiers::Avx512:
+				return "AVX-512";
+			default:
+				return "Unknown";
+		}
+	}
+
+	IsaTiers IsaDispatch::Tier()
+	{
+		struct Selection
+		{
+			IsaTiers Tier;
+
+			Selection()
+				:
+				Tier(Detected())
+			{
+				// an unrecognized value is ignored; a cap above the processor's tier would select instructions it can not execute
+				IsaTiers cap = IsaTiers::Scalar;
+
+				if (Parse(ReadEnvironment(), cap))
+					Tier = (std::min)(Tier, cap);
+			}
+		};
+
+		static const Selection SELECTED;
+
+		return SELECTED.Tier;
+	}
+
+	//~~~Private Methods~~~//
+
+	bool IsaDispatch::Parse(const std::string &Value, IsaTiers &Tier)
+	{
+		std::string name(Value);
+		std::transform(name.begin(), name.end(), name.begin(), [](char C) { return static_cast<char>(std::tolower(static_cast<unsigned char>(C))); });
+
+		if (name == "scalar")
+			Tier = IsaTiers::Scalar;
+		else if (name == "sse")
+			Tier = IsaTiers::Sse;
+		else if (name == "avx2")
+			Tier = IsaTiers::Avx2;
+		else if (name == "avx512")
+			Tier = IsaTiers::Avx512;
+		else
+			return false;
+
+		return true;
+	}
+
+	std::string IsaDispatch::ReadEnvironment()
+	{
+#if defined(CEX_OS_WINDOWS)
+		char* value = 0;
+		size_t length = 0;
+		std::string result;
+
+		if (_dupenv_s(&value, &length, ENVIRONMENT) == 0 && value != 0)
+			result = value;
+
+		free(value);
+
+		return result;
+#else
+		const char* VALUE = std::getenv(ENVIRONMENT);
+
+		return (VALUE != 0) ? std::string(VALUE) : std::string();
+#endif
+	}
+}
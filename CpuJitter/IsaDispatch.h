@@ -0,0 +1,141 @@
+#ifndef _CEXENGINE_ISADISPATCH_H
+#define _CEXENGINE_ISADISPATCH_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The instruction set tiers a kernel variant can be written for; each tier implies the ones below it
+	/// </summary>
+	enum class IsaTiers : int
+	{
+		/// <summary>
+		/// Portable C++; runs on every processor
+		/// </summary>
+		Scalar = 0,
+		/// <summary>
+		/// SSE2 through SSE4.2
+		/// </summary>
+		Sse = 1,
+		/// <summary>
+		/// AVX2 with the ymm state enabled by the operating system
+		/// </summary>
+		Avx2 = 2,
+		/// <summary>
+		/// AVX-512 F, BW and VL with the zmm and opmask state enabled by the operating system
+		/// </summary>
+		Avx512 = 3
+	};
+
+	/// <summary>
+	/// Resolves the instruction set tier used by the processor specific kernels.
+	/// <para>The tier is detected once per process from the CpuDetect snapshot and the operating system's saved register state.
+	/// The CEX_CJP_ISA environment variable (scalar, sse, avx2 or avx512) caps it for testing; it can lower the tier but never raise it above the processor's.
+	/// The variable is read on the first call, so it must be set before the first provider is constructed.</para>
+	/// </summary>
+	class IsaDispatch
+	{
+	public:
+
+		/// <summary>
+		/// The name of the environment variable that caps the tier
+		/// </summary>
+		static const char* ENVIRONMENT;
+
+		/// <summary>
+		/// Get the highest tier supported by this processor and operating system, ignoring the environment cap
+		/// </summary>
+		static IsaTiers Detected();
+
+		/// <summary>
+		/// Get the display name of a tier
+		/// </summary>
+		static const char* Name(IsaTiers Tier);
+
+		/// <summary>
+		/// Get the tier the kernels are resolved against; Detected, capped by the environment variable. Resolved once per process
+		/// </summary>
+		static IsaTiers Tier();
+
+	private:
+
+		static bool Parse(const std::string &Value, IsaTiers &Tier);
+		static std::string ReadEnvironment();
+	};
+
+	/// <summary>
+	/// A registry of the variants of one kernel, each tagged with the tier it requires.
+	/// <para>Variants are added fastest first; Resolve returns the first one whose tier is within IsaDispatch::Tier, falling back to the portable variant.
+	/// A kernel resolves its table once, from a function-local static, so a call pays an indirect call and no feature checks.
+	/// A variant that is value-initialized, such as a null function pointer, is treated as not built for this target and skipped.</para>
+	/// </summary>
+	///
+	/// <typeparam name="Kernel">The variant handle; a function pointer, or a kernel enumeration value</typeparam>
+	template <typename Kernel>
+	class KernelTable
+	{
+	private:
+		Kernel m_portable;
+		std::vector<std::pair<IsaTiers, Kernel>> m_variants;
+
+	public:
+
+		/// <summary>
+		/// Instantiate the table with the portable variant, which is used when no other variant qualifies
+		/// </summary>
+		///
+		/// <param name="Portable">The portable variant</param>
+		explicit KernelTable(Kernel Portable)
+			:
+			m_portable(Portable),
+			m_variants()
+		{
+		}
+
+		/// <summary>
+		/// Register a variant; variants are preferred in the order they are added
+		/// </summary>
+		///
+		/// <param name="Tier">The tier the variant requires</param>
+		/// <param name="Variant">The variant</param>
+		///
+		/// <returns>This table, so registrations can be chained</returns>
+		KernelTable &Add(IsaTiers Tier, Kernel Variant)
+		{
+			if (Variant != Kernel())
+				m_variants.push_back(std::make_pair(Tier, Variant));
+
+			return *this;
+		}
+
+		/// <summary>
+		/// Get the preferred variant within the dispatch tier
+		/// </summary>
+		Kernel Resolve() const
+		{
+			return Resolve([](Kernel) { return true; });
+		}
+
+		/// <summary>
+		/// Get the preferred variant within the dispatch tier that is also accepted by a check, such as a known answer test
+		/// </summary>
+		///
+		/// <param name="Accept">Returns true if the variant may be used</param>
+		template <typename Check>
+		Kernel Resolve(Check Accept) const
+		{
+			const IsaTiers CEILING = IsaDispatch::Tier();
+
+			for (size_t i = 0; i < m_variants.size(); ++i)
+			{
+				if (m_variants[i].first <= CEILING && Accept(m_variants[i].second))
+					return m_variants[i].second;
+			}
+
+			return m_portable;
+		}
+	};
+
+}
+#endif
@@ -0,0 +1,169 @@
+#ifndef _CEXENGINE_JITTERSTATISTICS_H
+#define _CEXENGINE_JITTERSTATISTICS_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// A snapshot of the hot path counters of a jitter provider.
+	/// <para>The tick counts are in units of the provider's timestamp source; processor reference cycles with the time stamp counter sources, nanoseconds with the clock sources.
+	/// All fields are zero unless the library is built with CEX_CJP_STATISTICS defined.</para>
+	/// </summary>
+	struct JitterStatistics
+	{
+		/// <summary>
+		/// The raw bits consumed by the debiasing extractor
+		/// </summary>
+		uint64_t ExtractorInput;
+		/// <summary>
+		/// The bits produced by the debiasing extractor
+		/// </summary>
+		uint64_t ExtractorOutput;
+		/// <summary>
+		/// The timer ticks spent in the CPU jitter noise source (FoldTime)
+		/// </summary>
+		uint64_t FoldTicks;
+		/// <summary>
+		/// The number of timing measurements (MeasureJitter calls)
+		/// </summary>
+		uint64_t Measurements;
+		/// <summary>
+		/// The timer ticks spent in the memory access noise source, including one timestamp read per measurement
+		/// </summary>
+		uint64_t MemoryTicks;
+		/// <summary>
+		/// The Von Neumann pairs discarded because both bits were equal
+		/// </summary>
+		uint64_t RejectedPairs;
+		/// <summary>
+		/// The measurements rejected by the stuck test; they are mixed but not credited
+		/// </summary>
+		uint64_t StuckCount;
+		/// <summary>
+		/// The number of timestamp reads made by the generator, not counting the reads of the counters themselves
+		/// </summary>
+		uint64_t TimerReads;
+		/// <summary>
+		/// The estimated timer ticks spent reading the timestamp; TimerReads times the read cost measured when the timer was selected
+		/// </summary>
+		uint64_t TimerTicks;
+		/// <summary>
+		/// The number of 64bit pool words generated, including priming and secure cache words
+		/// </summary>
+		uint64_t Words;
+	};
+
+#if defined(CEX_CJP_STATISTICS)
+
+	/// <summary>
+	/// The per instance hot path counters of a jitter provider.
+	/// <para>Each counter is a plain increment on the owning thread. The library is built without them by default; with CEX_CJP_STATISTICS undefined
+	/// this class is empty and every method compiles to nothing, and the timestamp reads that feed the tick counters are removed with it.</para>
+	/// </summary>
+	class JitterCounters
+	{
+	private:
+		JitterStatistics m_stats;
+
+	public:
+
+		/// <summary>
+		/// The counters are compiled in
+		/// </summary>
+		static const bool ENABLED = true;
+
+		JitterCounters()
+			:
+			m_stats()
+		{
+		}
+
+		/// <summary>
+		/// Count a raw bit consumed by the extractor
+		/// </summary>
+		inline void ExtractorInput() { ++m_stats.ExtractorInput; }
+
+		/// <summary>
+		/// Count a bit produced by the extractor
+		/// </summary>
+		inline void ExtractorOutput() { ++m_stats.ExtractorOutput; }
+
+		/// <summary>
+		/// Add the ticks of one pass through the CPU jitter noise source
+		/// </summary>
+		inline void Fold(uint64_t Ticks) { m_stats.FoldTicks += Ticks; }
+
+		/// <summary>
+		/// Count a timing measurement
+		/// </summary>
+		inline void Measurement() { ++m_stats.Measurements; }
+
+		/// <summary>
+		/// Add the ticks of one pass through the memory access noise source
+		/// </summary>
+		inline void Memory(uint64_t Ticks) { m_stats.MemoryTicks += Ticks; }
+
+		/// <summary>
+		/// Count a discarded Von Neumann pair
+		/// </summary>
+		inline void RejectedPair() { ++m_stats.RejectedPairs; }
+
+		/// <summary>
+		/// Zero every counter
+		/// </summary>
+		void Reset() { m_stats = JitterStatistics(); }
+
+		/// <summary>
+		/// Copy the counters
+		/// </summary>
+		///
+		/// <param name="ReadTicks">The cost of one timestamp read in ticks, used to estimate TimerTicks</param>
+		JitterStatistics Snapshot(double ReadTicks) const
+		{
+			JitterStatistics stats = m_stats;
+			stats.TimerTicks = static_cast<uint64_t>(ReadTicks * static_cast<double>(stats.TimerReads));
+
+			return stats;
+		}
+
+		/// <summary>
+		/// Count a measurement rejected by the stuck test
+		/// </summary>
+		inline void Stuck() { ++m_stats.StuckCount; }
+
+		/// <summary>
+		/// Count a timestamp read
+		/// </summary>
+		inline void TimerRead() { ++m_stats.TimerReads; }
+
+		/// <summary>
+		/// Count a generated pool word
+		/// </summary>
+		inline void Word() { ++m_stats.Words; }
+	};
+
+#else
+
+	class JitterCounters
+	{
+	public:
+		static const bool ENABLED = false;
+
+		inline void ExtractorInput() {}
+		inline void ExtractorOutput() {}
+		inline void Fold(uint64_t) {}
+		inline void Measurement() {}
+		inline void Memory(uint64_t) {}
+		inline void RejectedPair() {}
+		void Reset() {}
+		JitterStatistics Snapshot(double) const { return JitterStatistics(); }
+		inline void Stuck() {}
+		inline void TimerRead() {}
+		inline void Word() {}
+	};
+
+#endif
+
+}
+#endif
@@ -0,0 +1,88 @@
+#include "MappedFile.h"
+#include "CryptoRandomException.h"
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace CpuJitter
+{
+	//~~~Public Methods~~~//
+
+	void MappedFile::Close()
+	{
+		if (m_data != 0)
+		{
+#if defined(CEX_OS_WINDOWS)
+			UnmapViewOfFile(m_data);
+#else
+			munmap(const_cast<byte*>(m_data), m_size);
+#endif
+		}
+
+		m_data = 0;
+		m_size = 0;
+	}
+
+	void MappedFile::Open(const std::string &FilePath)
+	{
+		Close();
+
+		// the handles are closed once the view is mapped, the mapping holds its own reference to the file
+#if defined(CEX_OS_WINDOWS)
+		HANDLE file = CreateFileA(FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+
+		if (file == INVALID_HANDLE_VALUE)
+			throw CryptoRandomException("MappedFile:Open", "The file could not be opened!", FilePath);
+
+		LARGE_INTEGER fileSize;
+
+		if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0)
+		{
+			HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+
+			if (mapping != 0)
+			{
+				m_data = static_cast<const byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+				m_size = static_cast<size_t>(fileSize.QuadPart);
+				CloseHandle(mapping);
+			}
+		}
+
+		CloseHandle(file);
+#else
+		const int FILEDSC = open(FilePath.c_str(), O_RDONLY);
+
+		if (FILEDSC < 0)
+			throw CryptoRandomException("MappedFile:Open", "The file could not be opened!", FilePath);
+
+		struct stat fileStat;
+
+		if (fstat(FILEDSC, &fileStat) == 0 && fileStat.st_size > 0)
+		{
+			void* mapping = mmap(0, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, FILEDSC, 0);
+
+			if (mapping != MAP_FAILED)
+			{
+				m_data = static_cast<const byte*>(mapping);
+				m_size = static_cast<size_t>(fileStat.st_size);
+				// the readers walk the file front to back
+				madvise(mapping, m_size, MADV_SEQUENTIAL);
+			}
+		}
+
+		close(FILEDSC);
+#endif
+
+		if (m_data == 0)
+		{
+			m_size = 0;
+			throw CryptoRandomException("MappedFile:Open", "The file could not be mapped!", FilePath);
+		}
+	}
+}
@@ -0,0 +1,79 @@
+#ifndef _CEXENGINE_MAPPEDFILE_H
+#define _CEXENGINE_MAPPEDFILE_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// A read only memory mapping of a whole file.
+	/// <para>Pages are read in by the operating system as they are touched, so a file larger than the physical memory can be walked front to back.</para>
+	/// </summary>
+	class MappedFile
+	{
+	private:
+		const byte* m_data;
+		size_t m_size;
+
+	public:
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		MappedFile& operator=(MappedFile&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The first byte of the mapping, or null if no file is mapped
+		/// </summary>
+		const byte* Data() { return m_data; }
+
+		/// <summary>
+		/// Get: A file is mapped
+		/// </summary>
+		const bool IsOpen() { return m_data != 0; }
+
+		/// <summary>
+		/// Get: The length of the mapping in bytes
+		/// </summary>
+		const size_t Size() { return m_size; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate an empty mapping
+		/// </summary>
+		MappedFile()
+			:
+			m_data(0),
+			m_size(0)
+		{
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~MappedFile()
+		{
+			Close();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Unmap the file
+		/// </summary>
+		void Close();
+
+		/// <summary>
+		/// Map a file read only
+		/// </summary>
+		///
+		/// <param name="FilePath">The path of the file</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the file can not be opened or mapped, or is empty</exception>
+		void Open(const std::string &FilePath);
+	};
+
+}
+#endif
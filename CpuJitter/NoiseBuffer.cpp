@@ -0,0 +1,285 @@
+#include "NoiseBuffer.h"
+#include "CpuDetect.h"
+#include "CryptoRandomException.h"
+#include "NumaTopology.h"
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#else
+#	include <sys/mman.h>
+#endif
+
+#if defined(MAP_HUGETLB) && !defined(MAP_HUGE_2MB)
+	// the page size is encoded as its log2 in the flag bits above MAP_HUGE_SHIFT; linux 3.8 and later, older kernels use the default pool
+#	if !defined(MAP_HUGE_SHIFT)
+#		define MAP_HUGE_SHIFT 26
+#	endif
+#	define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+namespace CpuJitter
+{
+	//~~~Public Methods~~~//
+
+	void NoiseBuffer::Allocate(MemoryTargets Target, HugePages Pages, uint64_t Seed, int Node)
+	{
+		Destroy();
+
+		size_t lineSize = 0;
+		const size_t BUFSZE = TargetSize(Target, lineSize);
+
+		// huge page mappings are rounded up to whole 2MB pages
+		const size_t MAPSZE = (Pages == HugePages::None) ? BUFSZE : ((BUFSZE + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+
+		if (!Map(MAPSZE, Pages, Node))
+			throw CryptoRandomException("NoiseBuffer:Allocate", "The noise buffer could not be allocated!");
+
+		m_lineSize = lineSize;
+		m_size = BUFSZE;
+		memset(m_buffer, 0, m_size);
+		Permute(Seed);
+	}
+
+	void NoiseBuffer::Destroy()
+	{
+		if (m_buffer == 0)
+			return;
+
+		memset(m_buffer, 0, m_size);
+
+#if defined(CEX_OS_WINDOWS)
+		if (m_mapSize != 0)
+			VirtualFree(m_buffer, 0, MEM_RELEASE);
+		else
+			free(m_buffer);
+#else
+		if (m_mapSize != 0)
+			munmap(m_buffer, m_mapSize);
+		else
+			free(m_buffer);
+#endif
+
+		m_backing = HugePages::None;
+		m_buffer = 0;
+		m_lineSize = 0;
+		m_mapSize = 0;
+		m_node = -1;
+		m_size = 0;
+	}
+
+	const char* NoiseBuffer::Name(MemoryTargets Target)
+	{
+		switch (Target)
+		{
+			case MemoryTargets::L1:
+				return "L1";
+			case MemoryTargets::L2:
+				return "L2";
+			case MemoryTargets::L3:
+				return "L3";
+			case MemoryTargets::Dram:
+				return "DRAM";
+			default:
+				return "Unknown";
+		}
+	}
+
+	size_t NoiseBuffer::TargetSize(MemoryTargets Target, size_t &LineSize)
+	{
+		size_t l1Size = 0;
+		size_t l2Size = 0;
+		size_t l3Size = 0;
+
+		LineSize = 64;
+
+		try
+		{
+			std::shared_ptr<CpuDetect> detect = CpuDetect::Snapshot();
+			const CpuDetect::CacheInfo L1DATA = detect->DataCache(1);
+
+			if (L1DATA.Size != 0)
+			{
+				// the per thread share of the L1 data cache, split between the hyper-threads of the core
+				LineSize = L1DATA.LineSize;
+				l1Size = L1DATA.Size / ((L1DATA.SharedBy == 0) ? 1 : L1DATA.SharedBy);
+			}
+			else
+			{
+				// no cache enumeration; the original sizing from the legacy totals
+				const size_t VRTCRS = (detect->VirtualCores() == 0) ? 1 : detect->VirtualCores();
+				LineSize = detect->L1CacheLineSize();
+				l1Size = detect->L1CacheTotal() / VRTCRS;
+			}
+
+			l2Size = detect->DataCache(2).Size;
+			l3Size = detect->DataCache(3).Size;
+		}
+		catch (...)
+		{
+		}
+
+		if (LineSize == 0)
+			LineSize = 64;
+		if (l1Size == 0)
+			l1Size = 16 * 1024;
+		if (l2Size == 0)
+			l2Size = 128 * 1024;
+
+		size_t bufSize;
+
+		switch (Target)
+		{
+			case MemoryTargets::L2:
+			{
+				// past the L1 reach, within half of the L2 to leave room for the code and stack lines
+				bufSize = (std::max)(l2Size / 2, l1Size * 4);
+				break;
+			}
+			case MemoryTargets::L3:
+			{
+				// past the L2 reach and within half of the L3; four L2 sizes when the L3 is not reported
+				bufSize = (l3Size != 0) ? (std::max)((std::min)(l2Size * 4, l3Size / 2), l2Size * 2) : l2Size * 4;
+				break;
+			}
+			case MemoryTargets::Dram:
+			{
+				// several times the last level so that the walk can not stay resident in it
+				bufSize = (std::max)(DRAM_SIZE, (std::max)(l2Size * 64, l3Size * 4));
+				break;
+			}
+			default:
+			{
+				bufSize = l1Size;
+				break;
+			}
+		}
+
+		// the links are 32bit offsets
+		bufSize = (std::min)(bufSize, static_cast<size_t>(0x80000000UL));
+
+		return (std::max)(bufSize / LineSize, MIN_LINES) * LineSize;
+	}
+
+	//~~~Private Methods~~~//
+
+	bool NoiseBuffer::Map(size_t Length, HugePages Pages, int Node)
+	{
+		m_backing = HugePages::None;
+		m_node = -1;
+
+#if defined(CEX_OS_WINDOWS)
+		if (Pages == HugePages::Explicit)
+		{
+			// large pages need the lock pages in memory privilege; without it the allocation fails and regular pages are used
+			const size_t LRGPGE = GetLargePageMinimum();
+
+			if (LRGPGE != 0)
+			{
+				const size_t LRGSZE = ((Length + LRGPGE - 1) / LRGPGE) * LRGPGE;
+				const DWORD LRGFLG = MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES;
+				void* mem = (Node >= 0) ? VirtualAllocExNuma(GetCurrentProcess(), 0, LRGSZE, LRGFLG, PAGE_READWRITE, static_cast<DWORD>(Node)) : VirtualAlloc(0, LRGSZE, LRGFLG, PAGE_READWRITE);
+
+				if (mem != 0)
+				{
+					m_backing = HugePages::Explicit;
+					m_buffer = static_cast<byte*>(mem);
+					m_mapSize = LRGSZE;
+					m_node = Node;
+
+					return true;
+				}
+			}
+		}
+
+		if (Node >= 0)
+		{
+			void* mem = VirtualAllocExNuma(GetCurrentProcess(), 0, Length, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, static_cast<DWORD>(Node));
+
+			if (mem != 0)
+			{
+				m_buffer = static_cast<byte*>(mem);
+				m_mapSize = Length;
+				m_node = Node;
+
+				return true;
+			}
+		}
+#else
+		// a node binding needs a page aligned mapping of its own, the heap can not be bound
+		if (Pages != HugePages::None || Node >= 0)
+		{
+			void* mem = MAP_FAILED;
+
+#	if defined(MAP_HUGETLB)
+			if (Pages == HugePages::Explicit)
+			{
+				// the 2MB pool is named explicitly; the length is rounded to HUGE_PAGE_SIZE, and a mapping from a larger default pool would not unmap at that length.
+				// fails when the pool is empty; vm.nr_hugepages (or the hugepages-2048kB pool) must be reserved by the administrator
+				mem = mmap(0, Length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+
+				if (mem != MAP_FAILED)
+					m_backing = HugePages::Explicit;
+			}
+#	endif
+
+			if (mem == MAP_FAILED)
+			{
+				mem = mmap(0, Length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+#	if defined(MADV_HUGEPAGE)
+				if (mem != MAP_FAILED && Pages != HugePages::None && madvise(mem, Length, MADV_HUGEPAGE) == 0)
+					m_backing = HugePages::Transparent;
+#	endif
+			}
+
+			if (mem != MAP_FAILED)
+			{
+				m_buffer = static_cast<byte*>(mem);
+				m_mapSize = Length;
+
+				// the policy must be set before the first touch; if it is rejected the pages follow the first touch of the allocating thread
+				if (Node >= 0 && NumaTopology::BindMemory(mem, Length, static_cast<size_t>(Node)))
+					m_node = Node;
+
+				return true;
+			}
+		}
+#endif
+
+		m_buffer = static_cast<byte*>(malloc(Length));
+		m_mapSize = 0;
+
+		return m_buffer != 0;
+	}
+
+	void NoiseBuffer::Permute(uint64_t Seed)
+	{
+		// Sattolo's algorithm; shuffling the identity this way yields a permutation that is a single cycle through every line,
+		// each line stores its successor in place so no index array is needed
+		const size_t LNECNT = Lines();
+		uint64_t state = (Seed == 0) ? 0x9E3779B97F4A7C15ULL : Seed;
+
+		for (size_t i = 0; i < LNECNT; ++i)
+		{
+			const uint32_t OFFSET = static_cast<uint32_t>(i * m_lineSize);
+			memcpy(m_buffer + OFFSET, &OFFSET, sizeof(uint32_t));
+		}
+
+		for (size_t i = LNECNT - 1; i > 0; --i)
+		{
+			// xorshift64; the index in [0, i) is taken with a multiply and shift instead of a modulus
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+
+			const size_t J = static_cast<size_t>(((state >> 32) * static_cast<uint64_t>(i)) >> 32);
+			uint32_t lnkI;
+			uint32_t lnkJ;
+
+			memcpy(&lnkI, m_buffer + i * m_lineSize, sizeof(uint32_t));
+			memcpy(&lnkJ, m_buffer + J * m_lineSize, sizeof(uint32_t));
+			memcpy(m_buffer + i * m_lineSize, &lnkJ, sizeof(uint32_t));
+			memcpy(m_buffer + J * m_lineSize, &lnkI, sizeof(uint32_t));
+		}
+	}
+}
@@ -0,0 +1,173 @@
+#ifndef _CEXENGINE_NOISEBUFFER_H
+#define _CEXENGINE_NOISEBUFFER_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The level of the memory hierarchy targeted by the memory access noise source
+	/// </summary>
+	enum class MemoryTargets : int
+	{
+		/// <summary>
+		/// The per thread share of the L1 data cache; the original noise buffer size
+		/// </summary>
+		L1 = 0,
+		/// <summary>
+		/// A buffer larger than L1 that fits the L2 cache of one core
+		/// </summary>
+		L2 = 1,
+		/// <summary>
+		/// A buffer larger than L2 that is served from the shared L3 cache
+		/// </summary>
+		L3 = 2,
+		/// <summary>
+		/// A buffer larger than the caches; every access is a main memory access
+		/// </summary>
+		Dram = 3
+	};
+
+	/// <summary>
+	/// The page backing of the noise buffer
+	/// </summary>
+	enum class HugePages : int
+	{
+		/// <summary>
+		/// Regular pages from the heap
+		/// </summary>
+		None = 0,
+		/// <summary>
+		/// An anonymous mapping advised for transparent huge pages; the kernel may still use regular pages
+		/// </summary>
+		Transparent = 1,
+		/// <summary>
+		/// Explicit huge pages (MAP_HUGETLB, or large pages on windows); falls back to Transparent, then None, when the pool is empty or the privilege is missing
+		/// </summary>
+		Explicit = 2
+	};
+
+	/// <summary>
+	/// The memory of the memory access noise source.
+	/// <para>The buffer is split into cache lines that are linked into a single random cycle; the first 32bit word of every line holds the byte offset of the next line.
+	/// Following the links is a chain of dependent loads in an unpredictable order, which the hardware prefetchers can not run ahead of,
+	/// so every access pays the latency of the targeted cache level.</para>
+	/// </summary>
+	class NoiseBuffer
+	{
+	private:
+		static const size_t DRAM_SIZE = 256 * 1024 * 1024;
+		static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+		static const size_t MIN_LINES = 16;
+
+		HugePages m_backing;
+		byte* m_buffer;
+		size_t m_lineSize;
+		size_t m_mapSize;
+		int m_node;
+		size_t m_size;
+
+	public:
+
+		NoiseBuffer(const NoiseBuffer&) = delete;
+		NoiseBuffer& operator=(const NoiseBuffer&) = delete;
+		NoiseBuffer& operator=(NoiseBuffer&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The page backing obtained by the last Allocate; lower than the requested mode if a huge page allocation failed
+		/// </summary>
+		const HugePages Backing() { return m_backing; }
+
+		/// <summary>
+		/// Get: The first byte of the buffer; the chase starts at offset zero
+		/// </summary>
+		byte* Data() { return m_buffer; }
+
+		/// <summary>
+		/// Get: The number of linked cache lines
+		/// </summary>
+		const size_t Lines() { return (m_lineSize == 0) ? 0 : m_size / m_lineSize; }
+
+		/// <summary>
+		/// Get: The cache line size in bytes
+		/// </summary>
+		const size_t LineSize() { return m_lineSize; }
+
+		/// <summary>
+		/// Get: The NUMA node the buffer is bound to, or -1 if the pages are placed by the operating system
+		/// </summary>
+		const int Node() { return m_node; }
+
+		/// <summary>
+		/// Get: The usable size of the buffer in bytes
+		/// </summary>
+		const size_t Size() { return m_size; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate an empty buffer
+		/// </summary>
+		NoiseBuffer()
+			:
+			m_backing(HugePages::None),
+			m_buffer(0),
+			m_lineSize(0),
+			m_mapSize(0),
+			m_node(-1),
+			m_size(0)
+		{
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~NoiseBuffer()
+		{
+			Destroy();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Allocate the buffer and link its lines into a random cycle; an existing buffer is released first
+		/// </summary>
+		///
+		/// <param name="Target">The memory level the buffer is sized for</param>
+		/// <param name="Pages">The requested page backing</param>
+		/// <param name="Seed">Seeds the order of the cycle; it only needs to differ between instances, not to be secret</param>
+		/// <param name="Node">The NUMA node to bind the pages to before they are first touched; the default of -1 leaves the placement to the operating system</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the memory can not be allocated</exception>
+		void Allocate(MemoryTargets Target, HugePages Pages, uint64_t Seed, int Node = -1);
+
+		/// <summary>
+		/// Clear and release the buffer
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Get the display name of a memory target
+		/// </summary>
+		static const char* Name(MemoryTargets Target);
+
+		/// <summary>
+		/// Get the buffer size used for a memory target on this processor
+		/// </summary>
+		///
+		/// <param name="Target">The memory level</param>
+		/// <param name="LineSize">Receives the cache line size</param>
+		///
+		/// <returns>The buffer size in bytes, a multiple of the line size</returns>
+		static size_t TargetSize(MemoryTargets Target, size_t &LineSize);
+
+	private:
+
+		bool Map(size_t Length, HugePages Pages, int Node);
+		void Permute(uint64_t Seed);
+	};
+
+}
+#endif
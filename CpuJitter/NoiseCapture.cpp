@@ -0,0 +1,110 @@
+#include "NoiseCapture.h"
+#include "CpuDetect.h"
+#include "CryptoRandomException.h"
+#include <algorithm>
+#include <cstring>
+
+namespace CpuJitter
+{
+	static_assert(sizeof(CaptureHeader) == 144, "The capture header layout must not be padded");
+
+	const char* NoiseCapture::MAGIC = "CJPNOISE";
+
+	//~~~Public Methods~~~//
+
+	void NoiseCapture::Close()
+	{
+		if (m_file == 0)
+			return;
+
+		Flush();
+
+		// the index follows the last block; the final header replaces the provisional one
+		m_header.SampleCount = m_sampleCount;
+		m_header.BlockCount = m_blockOffsets.size();
+		m_header.IndexOffset = m_filePosition;
+
+		const size_t IDXLEN = m_blockOffsets.size();
+		bool written = (IDXLEN == 0 || std::fwrite(&m_blockOffsets[0], sizeof(uint64_t), IDXLEN, m_file) == IDXLEN);
+		written = written && std::fseek(m_file, 0, SEEK_SET) == 0;
+		written = written && std::fwrite(&m_header, sizeof(CaptureHeader), 1, m_file) == 1;
+		written = (std::fclose(m_file) == 0) && written;
+
+		m_file = 0;
+		m_blockOffsets.clear();
+		m_buffer.clear();
+		m_buffer.shrink_to_fit();
+
+		if (!written)
+			throw CryptoRandomException("NoiseCapture:Close", "The capture file could not be written!");
+	}
+
+	void NoiseCapture::Open(const std::string &FilePath, const CaptureHeader &Header)
+	{
+		Close();
+
+		m_file = std::fopen(FilePath.c_str(), "wb");
+
+		if (m_file == 0)
+			throw CryptoRandomException("NoiseCapture:Open", "The capture file could not be created!", FilePath);
+
+		// the stream buffer is not used, records are collected in the capture buffer
+		std::setvbuf(m_file, 0, _IONBF, 0);
+
+		m_header = Header;
+		std::memcpy(m_header.Magic, MAGIC, sizeof(m_header.Magic));
+		m_header.Version = VERSION;
+		m_header.HeaderSize = sizeof(CaptureHeader);
+		m_header.SampleCount = 0;
+		m_header.BlockCount = 0;
+		m_header.IndexOffset = 0;
+		m_header.BlockSamples = static_cast<uint32_t>(BLOCK_SAMPLES);
+		std::memset(m_header.Vendor, 0, sizeof(m_header.Vendor));
+		std::memset(m_header.Reserved, 0, sizeof(m_header.Reserved));
+
+		try
+		{
+			std::shared_ptr<CpuDetect> detect = CpuDetect::Snapshot();
+			const std::string VENDOR = detect->VendorName();
+
+			std::memcpy(m_header.Vendor, VENDOR.data(), (std::min)(VENDOR.size(), sizeof(m_header.Vendor)));
+			m_header.FrequencyBase = static_cast<uint32_t>(detect->FrequencyBase());
+			m_header.FrequencyMax = static_cast<uint32_t>(detect->FrequencyMax());
+			m_header.BusSpeed = static_cast<uint32_t>(detect->BusSpeed());
+			m_header.L1CacheSize = static_cast<uint32_t>(detect->L1CacheSize());
+			m_header.L1CacheLineSize = static_cast<uint32_t>(detect->L1CacheLineSize());
+			m_header.L2CacheSize = static_cast<uint32_t>(detect->L2CacheSize());
+			m_header.PhysicalCores = static_cast<uint32_t>(detect->PhysicalCores());
+			m_header.VirtualCores = static_cast<uint32_t>(detect->VirtualCores());
+		}
+		catch (...)
+		{
+			// the processor fields stay as the caller set them
+		}
+
+		m_blockOffsets.clear();
+		m_buffer.resize(BUFFER_SIZE);
+		m_bufferPosition = 0;
+		m_filePosition = 0;
+		m_lastDelta = 0;
+		m_lastSource = 0;
+		m_sampleCount = 0;
+
+		std::memcpy(&m_buffer[0], &m_header, sizeof(CaptureHeader));
+		m_bufferPosition = sizeof(CaptureHeader);
+	}
+
+	//~~~Private Methods~~~//
+
+	void NoiseCapture::Flush()
+	{
+		if (m_bufferPosition == 0)
+			return;
+
+		if (std::fwrite(&m_buffer[0], 1, m_bufferPosition, m_file) != m_bufferPosition)
+			throw CryptoRandomException("NoiseCapture:Flush", "The capture file could not be written!");
+
+		m_filePosition += m_bufferPosition;
+		m_bufferPosition = 0;
+	}
+}
@@ -0,0 +1,289 @@
+#ifndef _CEXENGINE_NOISECAPTURE_H
+#define _CEXENGINE_NOISECAPTURE_H
+
+#include "Config.h"
+#include <cstdio>
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The fixed header at the start of a raw noise capture file.
+	/// <para>All fields are little endian. The processor fields are filled by NoiseCapture from CpuDetect, the configuration fields by the capturing provider.</para>
+	/// </summary>
+	struct CaptureHeader
+	{
+		/// <summary>
+		/// The file signature, NoiseCapture::MAGIC
+		/// </summary>
+		byte Magic[8];
+		/// <summary>
+		/// The format version
+		/// </summary>
+		uint32_t Version;
+		/// <summary>
+		/// The size of this header in bytes; the first block follows it
+		/// </summary>
+		uint32_t HeaderSize;
+		/// <summary>
+		/// The number of captured measurements
+		/// </summary>
+		uint64_t SampleCount;
+		/// <summary>
+		/// The number of encoded blocks
+		/// </summary>
+		uint64_t BlockCount;
+		/// <summary>
+		/// The file offset of the block index; BlockCount 64bit file offsets, one per block
+		/// </summary>
+		uint64_t IndexOffset;
+		/// <summary>
+		/// The number of measurements in every block but the last
+		/// </summary>
+		uint32_t BlockSamples;
+		/// <summary>
+		/// The capture flags; NoiseCapture::FLAG_SOURCES if every record carries the memory access time
+		/// </summary>
+		uint32_t Flags;
+		/// <summary>
+		/// The processor vendor string, zero padded
+		/// </summary>
+		char Vendor[16];
+		/// <summary>
+		/// The processor base frequency in MHz; zero if the processor does not report it
+		/// </summary>
+		uint32_t FrequencyBase;
+		/// <summary>
+		/// The processor maximum frequency in MHz; zero if the processor does not report it
+		/// </summary>
+		uint32_t FrequencyMax;
+		/// <summary>
+		/// The processor bus frequency in MHz; zero if the processor does not report it
+		/// </summary>
+		uint32_t BusSpeed;
+		/// <summary>
+		/// The L1 cache size of one core in bytes
+		/// </summary>
+		uint32_t L1CacheSize;
+		/// <summary>
+		/// The cache line size in bytes
+		/// </summary>
+		uint32_t L1CacheLineSize;
+		/// <summary>
+		/// The L2 cache size of one core in bytes
+		/// </summary>
+		uint32_t L2CacheSize;
+		/// <summary>
+		/// The number of physical cores
+		/// </summary>
+		uint32_t PhysicalCores;
+		/// <summary>
+		/// The number of logical processors
+		/// </summary>
+		uint32_t VirtualCores;
+		/// <summary>
+		/// The TimerSources value of the timestamp source
+		/// </summary>
+		uint32_t TimerSource;
+		/// <summary>
+		/// The memory access noise source was enabled
+		/// </summary>
+		uint32_t EnableAccess;
+		/// <summary>
+		/// The MemoryTargets value of the memory noise buffer
+		/// </summary>
+		uint32_t MemoryTarget;
+		/// <summary>
+		/// The HugePages value of the memory noise buffer's actual backing
+		/// </summary>
+		uint32_t MemoryBacking;
+		/// <summary>
+		/// The NUMA node of the memory noise buffer, or -1
+		/// </summary>
+		int32_t MemoryNode;
+		/// <summary>
+		/// The Extractors value of the debiasing extractor, or zero if debiasing was disabled
+		/// </summary>
+		uint32_t Extractor;
+		/// <summary>
+		/// The HarvestBits setting
+		/// </summary>
+		uint32_t HarvestBits;
+		/// <summary>
+		/// The OverSampleRate setting
+		/// </summary>
+		uint32_t OverSampleRate;
+		/// <summary>
+		/// Reserved, zero
+		/// </summary>
+		uint32_t Reserved[4];
+	};
+
+	/// <summary>
+	/// Writes raw timing measurements to a compact capture file.
+	/// <para>Measurements are grouped into blocks of BLOCK_SAMPLES; within a block every value is stored as the zigzag LEB128 varint of its difference from the previous value,
+	/// so a block decodes without the blocks before it. With source timings each record is the delta followed by the memory access time, each with its own difference chain.
+	/// The block offsets are written as an index after the last block and the header is rewritten on Close, so a reader can map the file and decode any block directly.
+	/// Records are encoded into a large memory buffer that is written to the file only when full.</para>
+	/// </summary>
+	class NoiseCapture
+	{
+	public:
+
+		/// <summary>
+		/// The number of measurements in a block
+		/// </summary>
+		static const size_t BLOCK_SAMPLES = 65536;
+
+		/// <summary>
+		/// The header flag set when records carry the memory access time
+		/// </summary>
+		static const uint32_t FLAG_SOURCES = 1;
+
+		/// <summary>
+		/// The file signature
+		/// </summary>
+		static const char* MAGIC;
+
+		/// <summary>
+		/// The format version written by this class
+		/// </summary>
+		static const uint32_t VERSION = 1;
+
+	private:
+		static const size_t BUFFER_SIZE = 4 * 1024 * 1024;
+		// two 64bit varints of ten bytes each
+		static const size_t RECORD_MAX = 20;
+
+		std::vector<uint64_t> m_blockOffsets;
+		std::vector<byte> m_buffer;
+		size_t m_bufferPosition;
+		std::FILE* m_file;
+		uint64_t m_filePosition;
+		CaptureHeader m_header;
+		uint64_t m_lastDelta;
+		uint64_t m_lastSource;
+		uint64_t m_sampleCount;
+
+	public:
+
+		NoiseCapture(const NoiseCapture&) = delete;
+		NoiseCapture& operator=(const NoiseCapture&) = delete;
+		NoiseCapture& operator=(NoiseCapture&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: A capture file is open
+		/// </summary>
+		const bool IsOpen() { return m_file != 0; }
+
+		/// <summary>
+		/// Get: The number of measurements written since Open
+		/// </summary>
+		const uint64_t Samples() { return m_sampleCount; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate a closed capture
+		/// </summary>
+		NoiseCapture()
+			:
+			m_blockOffsets(0),
+			m_buffer(0),
+			m_bufferPosition(0),
+			m_file(0),
+			m_filePosition(0),
+			m_header(),
+			m_lastDelta(0),
+			m_lastSource(0),
+			m_sampleCount(0)
+		{
+		}
+
+		/// <summary>
+		/// Destructor; an open capture is closed
+		/// </summary>
+		~NoiseCapture()
+		{
+			try
+			{
+				Close();
+			}
+			catch (...)
+			{
+			}
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Flush the buffer, write the block index and the final header, and close the file
+		/// </summary>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the file can not be written</exception>
+		void Close();
+
+		/// <summary>
+		/// Create the capture file and write a provisional header
+		/// </summary>
+		///
+		/// <param name="FilePath">The path of the file; an existing file is replaced</param>
+		/// <param name="Header">The configuration fields of the header; the signature, counts and processor fields are filled in</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the file can not be created</exception>
+		void Open(const std::string &FilePath, const CaptureHeader &Header);
+
+		/// <summary>
+		/// Append a measurement
+		/// </summary>
+		///
+		/// <param name="Delta">The raw timing delta</param>
+		/// <param name="Source">The memory access time; ignored unless the header sets FLAG_SOURCES</param>
+		inline void Sample(uint64_t Delta, uint64_t Source = 0)
+		{
+			if (m_sampleCount % BLOCK_SAMPLES == 0)
+			{
+				// a block restarts both difference chains
+				m_blockOffsets.push_back(m_filePosition + m_bufferPosition);
+				m_lastDelta = 0;
+				m_lastSource = 0;
+			}
+
+			if (m_bufferPosition > BUFFER_SIZE - RECORD_MAX)
+				Flush();
+
+			PutVarint(Delta - m_lastDelta);
+			m_lastDelta = Delta;
+
+			if (m_header.Flags & FLAG_SOURCES)
+			{
+				PutVarint(Source - m_lastSource);
+				m_lastSource = Source;
+			}
+
+			++m_sampleCount;
+		}
+
+	private:
+
+		void Flush();
+
+		inline void PutVarint(uint64_t Difference)
+		{
+			// zigzag maps the two's complement difference to small unsigned values for either sign
+			const int64_t SGNDIF = static_cast<int64_t>(Difference);
+			uint64_t value = (static_cast<uint64_t>(SGNDIF) << 1) ^ static_cast<uint64_t>(SGNDIF >> 63);
+
+			while (value >= 0x80)
+			{
+				m_buffer[m_bufferPosition++] = static_cast<byte>(value | 0x80);
+				value >>= 7;
+			}
+
+			m_buffer[m_bufferPosition++] = static_cast<byte>(value);
+		}
+	};
+
+}
+#endif
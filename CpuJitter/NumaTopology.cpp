@@ -0,0 +1,244 @@
+#include "NumaTopology.h"
+#include <fstream>
+#include <sstream>
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#elif defined(CEX_OS_LINUX)
+#	include <pthread.h>
+#	include <sched.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace CpuJitter
+{
+#if defined(CEX_OS_LINUX)
+	namespace
+	{
+		// the mbind policy value from linux/mempolicy.h; the syscall is used directly so that libnuma is not required
+		const int MPOL_BIND_POLICY = 2;
+		const std::string NODE_PATH = "/sys/devices/system/node/";
+	}
+#endif
+
+	//~~~Public Methods~~~//
+
+	bool NumaTopology::BindMemory(void* Address, size_t Length, size_t Node)
+	{
+#if defined(CEX_OS_LINUX) && defined(SYS_mbind)
+		const size_t MSKBTS = sizeof(unsigned long) * 8;
+		std::vector<unsigned long> mask((Node / MSKBTS) + 1, 0);
+
+		mask[Node / MSKBTS] |= 1UL << (Node % MSKBTS);
+
+		return syscall(SYS_mbind, Address, Length, MPOL_BIND_POLICY, &mask[0], mask.size() * MSKBTS, 0) == 0;
+#else
+		// windows binds at allocation time with VirtualAllocExNuma
+		(void)Address;
+		(void)Length;
+		(void)Node;
+
+		return false;
+#endif
+	}
+
+	bool NumaTopology::BindThread(size_t Node)
+	{
+#if defined(CEX_OS_WINDOWS)
+		ULONGLONG mask = 0;
+
+		if (Node > 0xFF || !GetNumaNodeProcessorMask(static_cast<UCHAR>(Node), &mask) || mask == 0)
+			return false;
+
+		return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(mask)) != 0;
+#elif defined(CEX_OS_LINUX)
+		const std::vector<size_t> CPUS = NodeCpus(Node);
+
+		if (CPUS.size() == 0)
+			return false;
+
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+
+		for (size_t i = 0; i < CPUS.size(); ++i)
+		{
+			if (CPUS[i] < CPU_SETSIZE)
+				CPU_SET(CPUS[i], &cpuSet);
+		}
+
+		return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+		(void)Node;
+
+		return false;
+#endif
+	}
+
+	int NumaTopology::CurrentNode()
+	{
+#if defined(CEX_OS_WINDOWS)
+		UCHAR node = 0;
+
+		if (!GetNumaProcessorNode(static_cast<UCHAR>(GetCurrentProcessorNumber()), &node) || node == 0xFF)
+			return -1;
+
+		return static_cast<int>(node);
+#elif defined(CEX_OS_LINUX)
+		const int CPU = sched_getcpu();
+
+		return (CPU < 0) ? -1 : NodeOfCpu(static_cast<size_t>(CPU));
+#else
+		return 0;
+#endif
+	}
+
+	size_t NumaTopology::NodeCount()
+	{
+#if defined(CEX_OS_WINDOWS)
+		ULONG highest = 0;
+
+		if (!GetNumaHighestNodeNumber(&highest))
+			return 1;
+
+		return static_cast<size_t>(highest) + 1;
+#elif defined(CEX_OS_LINUX)
+		const std::vector<size_t> NODES = ParseList(ReadLine(NODE_PATH + "online"));
+
+		return (NODES.size() == 0) ? 1 : NODES.size();
+#else
+		return 1;
+#endif
+	}
+
+	std::vector<size_t> NumaTopology::NodeCpus(size_t Node)
+	{
+		std::vector<size_t> cpus;
+
+#if defined(CEX_OS_WINDOWS)
+		ULONGLONG mask = 0;
+
+		if (Node <= 0xFF && GetNumaNodeProcessorMask(static_cast<UCHAR>(Node), &mask))
+		{
+			for (size_t i = 0; i < sizeof(mask) * 8; ++i)
+			{
+				if ((mask >> i) & 1)
+					cpus.push_back(i);
+			}
+		}
+#elif defined(CEX_OS_LINUX)
+		cpus = ParseList(ReadLine(NODE_PATH + "node" + std::to_string(Node) + "/cpulist"));
+#else
+		(void)Node;
+#endif
+
+		return cpus;
+	}
+
+	int NumaTopology::NodeOfCpu(size_t Cpu)
+	{
+#if defined(CEX_OS_WINDOWS)
+		UCHAR node = 0;
+
+		if (Cpu > 0xFF || !GetNumaProcessorNode(static_cast<UCHAR>(Cpu), &node) || node == 0xFF)
+			return -1;
+
+		return static_cast<int>(node);
+#elif defined(CEX_OS_LINUX)
+		const std::vector<size_t> NODES = ParseList(ReadLine(NODE_PATH + "online"));
+
+		for (size_t i = 0; i < NODES.size(); ++i)
+		{
+			const std::vector<size_t> CPUS = NodeCpus(NODES[i]);
+
+			for (size_t j = 0; j < CPUS.size(); ++j)
+			{
+				if (CPUS[j] == Cpu)
+					return static_cast<int>(NODES[i]);
+			}
+		}
+
+		return -1;
+#else
+		(void)Cpu;
+
+		return 0;
+#endif
+	}
+
+	size_t NumaTopology::RemoteNode(size_t Node)
+	{
+#if defined(CEX_OS_LINUX)
+		// the distance file holds one SLIT entry per online node, in node order
+		const std::vector<size_t> NODES = ParseList(ReadLine(NODE_PATH + "online"));
+		std::istringstream distances(ReadLine(NODE_PATH + "node" + std::to_string(Node) + "/distance"));
+		size_t remote = Node;
+		size_t maxDist = 0;
+		size_t dist = 0;
+
+		for (size_t i = 0; i < NODES.size() && (distances >> dist); ++i)
+		{
+			if (NODES[i] != Node && dist > maxDist)
+			{
+				maxDist = dist;
+				remote = NODES[i];
+			}
+		}
+
+		return remote;
+#else
+		// no distance table; the next node
+		const size_t NODCNT = NodeCount();
+
+		return (NODCNT < 2) ? Node : (Node + 1) % NODCNT;
+#endif
+	}
+
+	//~~~Private Methods~~~//
+
+	std::vector<size_t> NumaTopology::ParseList(const std::string &List)
+	{
+		// the sysfs list format; comma separated indices and inclusive ranges, as in 0-3,8-11
+		std::vector<size_t> values;
+		std::istringstream stream(List);
+		std::string item;
+
+		while (std::getline(stream, item, ','))
+		{
+			const size_t DSHPOS = item.find('-');
+
+			try
+			{
+				if (DSHPOS == std::string::npos)
+				{
+					values.push_back(static_cast<size_t>(std::stoul(item)));
+				}
+				else
+				{
+					const size_t FIRST = static_cast<size_t>(std::stoul(item.substr(0, DSHPOS)));
+					const size_t LAST = static_cast<size_t>(std::stoul(item.substr(DSHPOS + 1)));
+
+					for (size_t i = FIRST; i <= LAST; ++i)
+						values.push_back(i);
+				}
+			}
+			catch (...)
+			{
+				// an empty or malformed entry
+			}
+		}
+
+		return values;
+	}
+
+	std::string NumaTopology::ReadLine(const std::string &Path)
+	{
+		std::ifstream file(Path.c_str());
+		std::string line;
+
+		if (file.is_open())
+			std::getline(file, line);
+
+		return line;
+	}
+}
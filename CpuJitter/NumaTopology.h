@@ -0,0 +1,99 @@
+#ifndef _CEXENGINE_NUMATOPOLOGY_H
+#define _CEXENGINE_NUMATOPOLOGY_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The NUMA node placement of a memory noise buffer
+	/// </summary>
+	enum class NumaPlacements : int
+	{
+		/// <summary>
+		/// No memory policy; the operating system places the pages
+		/// </summary>
+		Unbound = 0,
+		/// <summary>
+		/// The pages are bound to the node of the processor that runs Reset
+		/// </summary>
+		Local = 1,
+		/// <summary>
+		/// The pages are bound to the most distant other node; the interconnect latency becomes an additional noise source
+		/// </summary>
+		Remote = 2
+	};
+
+	/// <summary>
+	/// NUMA node enumeration and binding.
+	/// <para>Nodes are read from sysfs on linux and from the NUMA api on windows; other platforms, and hosts with a single node, report one node and binding does nothing.</para>
+	/// </summary>
+	class NumaTopology
+	{
+	public:
+
+		/// <summary>
+		/// Bind a memory region to a node; the pages must not have been touched yet
+		/// </summary>
+		///
+		/// <param name="Address">The page aligned start of the region</param>
+		/// <param name="Length">The length of the region in bytes</param>
+		/// <param name="Node">The node index</param>
+		///
+		/// <returns>Returns true if the memory policy was applied</returns>
+		static bool BindMemory(void* Address, size_t Length, size_t Node);
+
+		/// <summary>
+		/// Restrict the calling thread to the processors of a node
+		/// </summary>
+		///
+		/// <param name="Node">The node index</param>
+		///
+		/// <returns>Returns true if the affinity was changed</returns>
+		static bool BindThread(size_t Node);
+
+		/// <summary>
+		/// Get the node of the processor running the calling thread
+		/// </summary>
+		///
+		/// <returns>The node index, or -1 if it can not be determined</returns>
+		static int CurrentNode();
+
+		/// <summary>
+		/// Get the number of nodes on this system; at least 1
+		/// </summary>
+		static size_t NodeCount();
+
+		/// <summary>
+		/// Get the logical processors of a node
+		/// </summary>
+		///
+		/// <param name="Node">The node index</param>
+		static std::vector<size_t> NodeCpus(size_t Node);
+
+		/// <summary>
+		/// Get the node of a logical processor
+		/// </summary>
+		///
+		/// <param name="Cpu">The logical processor index</param>
+		///
+		/// <returns>The node index, or -1 if it can not be determined</returns>
+		static int NodeOfCpu(size_t Cpu);
+
+		/// <summary>
+		/// Get the most distant node from a node, by the firmware distance table
+		/// </summary>
+		///
+		/// <param name="Node">The node index</param>
+		///
+		/// <returns>The most distant other node, or Node on a single node system</returns>
+		static size_t RemoteNode(size_t Node);
+
+	private:
+
+		static std::vector<size_t> ParseList(const std::string &List);
+		static std::string ReadLine(const std::string &Path);
+	};
+
+}
+#endif
@@ -0,0 +1,494 @@
+#include "ParallelCJP.h"
+#include "CpuDetect.h"
+#include "CryptoRandomException.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#if defined(CEX_OS_WINDOWS)
+#	include <Windows.h>
+#elif defined(CEX_OS_LINUX)
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
+namespace CpuJitter
+{
+	const EntropyEstimate ParallelCJP::Estimate()
+	{
+		EntropyEstimate est = { 0.0, 0.0, 0.0, 0.0, 0, 0.0 };
+
+		for (size_t i = 0; i < m_providers.size(); ++i)
+		{
+			const EntropyEstimate WRKEST = m_providers[i]->Estimate();
+
+			if (i == 0)
+			{
+				est = WRKEST;
+				continue;
+			}
+
+			est.BitMcv = (std::min)(est.BitMcv, WRKEST.BitMcv);
+			est.Collision = (std::min)(est.Collision, WRKEST.Collision);
+			est.Markov = (std::min)(est.Markov, WRKEST.Markov);
+			est.MinEntropy = (std::min)(est.MinEntropy, WRKEST.MinEntropy);
+			est.Samples = (std::min)(est.Samples, WRKEST.Samples);
+			est.SymbolMcv = (std::min)(est.SymbolMcv, WRKEST.SymbolMcv);
+		}
+
+		return est;
+	}
+
+	const uint32_t ParallelCJP::RequiredOverSampleRate()
+	{
+		uint32_t rate = 0;
+
+		for (size_t i = 0; i < m_providers.size(); ++i)
+		{
+			const uint32_t WRKRTE = m_providers[i]->RequiredOverSampleRate();
+
+			if (WRKRTE == 0)
+				return 0;
+
+			rate = (std::max)(rate, WRKRTE);
+		}
+
+		return rate;
+	}
+
+	const JitterStatistics ParallelCJP::Statistics()
+	{
+		JitterStatistics stats = JitterStatistics();
+
+		for (size_t i = 0; i < m_providers.size(); ++i)
+		{
+			const JitterStatistics WRKSTS = m_providers[i]->Statistics();
+
+			stats.ExtractorInput += WRKSTS.ExtractorInput;
+			stats.ExtractorOutput += WRKSTS.ExtractorOutput;
+			stats.FoldTicks += WRKSTS.FoldTicks;
+			stats.Measurements += WRKSTS.Measurements;
+			stats.MemoryTicks += WRKSTS.MemoryTicks;
+			stats.RejectedPairs += WRKSTS.RejectedPairs;
+			stats.StuckCount += WRKSTS.StuckCount;
+			stats.TimerReads += WRKSTS.TimerReads;
+			stats.TimerTicks += WRKSTS.TimerTicks;
+			stats.Words += WRKSTS.Words;
+		}
+
+		return stats;
+	}
+
+	void ParallelCJP::Destroy()
+	{
+		StopWorkers();
+
+		for (size_t i = 0; i < m_providers.size(); ++i)
+		{
+			if (m_providers[i])
+				m_providers[i]->Destroy();
+		}
+
+		m_providers.clear();
+		m_cpuMap.clear();
+		m_errors.clear();
+		m_tasks.clear();
+		m_isAvailable = false;
+		m_overSampleRate = 0;
+		m_parallelMinSize = 0;
+	}
+
+	void ParallelCJP::GetBytes(std::vector<byte> &Output)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("ParallelCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+
+		if (Output.size() != 0)
+			Generate(&Output[0], Output.size());
+	}
+
+	void ParallelCJP::GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("ParallelCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+		if (Offset + Length > Output.size())
+			throw CryptoRandomException("ParallelCJP:GetBytes", "The array is too small to fulfill this request!");
+
+		if (Length != 0)
+			Generate(&Output[Offset], Length);
+	}
+
+	void ParallelCJP::GetBytes(byte* Output, size_t Length)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("ParallelCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+		if (Output == 0 && Length != 0)
+			throw CryptoRandomException("ParallelCJP:GetBytes", "The output pointer can not be null!");
+
+		if (Length != 0)
+			Generate(Output, Length);
+	}
+
+	std::vector<byte> ParallelCJP::GetBytes(size_t Length)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("ParallelCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+
+		std::vector<byte> data(Length);
+
+		if (Length != 0)
+			Generate(&data[0], data.size());
+
+		return data;
+	}
+
+	uint32_t ParallelCJP::Next()
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException("ParallelCJP:Next", "High resolution timer not available or too coarse for RNG!");
+
+		uint32_t rnd = 0;
+		Generate(reinterpret_cast<byte*>(&rnd), sizeof(uint32_t));
+
+		return rnd;
+	}
+
+	void ParallelCJP::Reset()
+	{
+		std::lock_guard<std::mutex> dispatch(m_dispatchLock);
+
+		UpdateSettings();
+
+		// the restarted workers pin themselves with the current PinThreads setting, then rebuild their states on their own processors
+		StopWorkers();
+		StartWorkers();
+
+		const WorkerTask RSTTSK = { true, 0, 0, true };
+		Dispatch(std::vector<WorkerTask>(m_providers.size(), RSTTSK));
+	}
+
+	void ParallelCJP::ResetStatistics()
+	{
+		for (size_t i = 0; i < m_providers.size(); ++i)
+			m_providers[i]->ResetStatistics();
+	}
+
+	void ParallelCJP::Dispatch(const std::vector<WorkerTask> &Tasks)
+	{
+		// the caller holds m_dispatchLock; the task table and completion count are shared, a second caller must not replace them, or wake on their completion, while a batch is running
+		std::exception_ptr error;
+
+		{
+			std::unique_lock<std::mutex> lock(m_taskLock);
+
+			m_tasks = Tasks;
+			m_pendingTasks = static_cast<size_t>(std::count_if(Tasks.begin(), Tasks.end(), [](const WorkerTask &Task) { return Task.Active; }));
+
+			for (size_t i = 0; i < m_errors.size(); ++i)
+				m_errors[i] = nullptr;
+
+			++m_taskGeneration;
+			m_taskSignal.notify_all();
+			m_doneSignal.wait(lock, [this]() { return m_pendingTasks == 0; });
+
+			for (size_t i = 0; i < m_errors.size() && !error; ++i)
+				error = m_errors[i];
+		}
+
+		if (error)
+			std::rethrow_exception(error);
+	}
+
+	void ParallelCJP::Generate(byte* Output, size_t Length)
+	{
+		// held until the batch completes; the settings are copied to the states only while no worker is running
+		std::lock_guard<std::mutex> dispatch(m_dispatchLock);
+
+		UpdateSettings();
+
+		const size_t PRCCNT = m_providers.size();
+		// slice on word boundaries so that each worker produces only whole 64bit words, the last slice takes the remainder
+		const size_t SLCSZE = ((Length / PRCCNT) / WORD_SIZE) * WORD_SIZE;
+		const WorkerTask IDLTSK = { false, 0, 0, false };
+		std::vector<WorkerTask> tasks(PRCCNT, IDLTSK);
+
+		if (PRCCNT == 1 || SLCSZE == 0 || Length < m_parallelMinSize)
+		{
+			// small requests are not worth splitting; the first worker generates them on its own processor
+			tasks[0].Active = true;
+			tasks[0].Length = Length;
+			tasks[0].Output = Output;
+		}
+		else
+		{
+			for (size_t i = 0; i < PRCCNT; ++i)
+			{
+				tasks[i].Active = true;
+				tasks[i].Length = (i == PRCCNT - 1) ? Length - (i * SLCSZE) : SLCSZE;
+				tasks[i].Output = Output + (i * SLCSZE);
+			}
+		}
+
+		Dispatch(tasks);
+	}
+
+	void ParallelCJP::Initialize(size_t ProcessorCount)
+	{
+		size_t phyCores = 1;
+		size_t lgcPerCore = 1;
+		std::vector<CpuDetect::ProcessorInfo> procs;
+
+		try
+		{
+			std::shared_ptr<CpuDetect> detect = CpuDetect::Snapshot();
+			phyCores = detect->PhysicalCores() != 0 ? detect->PhysicalCores() : 1;
+			lgcPerCore = detect->LogicalPerCore() != 0 ? detect->LogicalPerCore() : 1;
+			procs = detect->Processors();
+		}
+		catch (...)
+		{
+			phyCores = 1;
+			lgcPerCore = 1;
+			procs.clear();
+		}
+
+		// only the processors the process may currently run on; a restricted cpu set must not stack workers on one processor
+		const std::vector<size_t> ALLOWED = CpuDetect::AllowedProcessors();
+
+		if (!ALLOWED.empty())
+		{
+			procs.erase(std::remove_if(procs.begin(), procs.end(), [&ALLOWED](const CpuDetect::ProcessorInfo &Info)
+			{
+				return !std::binary_search(ALLOWED.begin(), ALLOWED.end(), Info.Cpu);
+			}), procs.end());
+		}
+
+		if (!procs.empty())
+		{
+			// the preferred core type first; then either the first thread of every core before any sibling, or every sibling of a core together
+			const CpuDetect::CoreTypes PREFER = m_preferredCores;
+			const bool BYCORE = (m_placement == WorkerPlacements::Cores);
+
+			std::stable_sort(procs.begin(), procs.end(), [PREFER, BYCORE](const CpuDetect::ProcessorInfo &A, const CpuDetect::ProcessorInfo &B)
+			{
+				const size_t ARANK = (PREFER == CpuDetect::CoreTypes::Unknown || A.Type == PREFER) ? 0 : 1;
+				const size_t BRANK = (PREFER == CpuDetect::CoreTypes::Unknown || B.Type == PREFER) ? 0 : 1;
+
+				if (BYCORE && A.Thread != B.Thread)
+					return A.Thread < B.Thread;
+				if (ARANK != BRANK)
+					return ARANK < BRANK;
+				if (A.Package != B.Package)
+					return A.Package < B.Package;
+				if (A.Core != B.Core)
+					return A.Core < B.Core;
+
+				return A.Thread < B.Thread;
+			});
+
+			if (ProcessorCount == 0)
+			{
+				ProcessorCount = BYCORE ? static_cast<size_t>(std::count_if(procs.begin(), procs.end(), [](const CpuDetect::ProcessorInfo &Info) { return Info.Thread == 0; })) : procs.size();
+
+				if (ProcessorCount == 0)
+					ProcessorCount = 1;
+			}
+
+			for (size_t i = 0; i < ProcessorCount; ++i)
+				m_cpuMap.push_back(procs[i % procs.size()].Cpu);
+		}
+		else
+		{
+			// no topology from the operating system; never exceed the number of processors it reports
+			const size_t SYSCPU = static_cast<size_t>(std::thread::hardware_concurrency());
+			if (SYSCPU != 0 && phyCores > SYSCPU)
+				phyCores = SYSCPU;
+
+			if (ProcessorCount == 0)
+				ProcessorCount = phyCores;
+
+			// map each worker to the first logical processor of a distinct physical core;
+			// windows enumerates smt siblings adjacently, linux enumerates one thread of every core before the siblings
+#if defined(CEX_OS_WINDOWS)
+			const size_t CPUSTRD = lgcPerCore;
+#else
+			const size_t CPUSTRD = 1;
+			(void)lgcPerCore;
+#endif
+
+			for (size_t i = 0; i < ProcessorCount; ++i)
+			{
+				size_t cpu = (i % phyCores) * CPUSTRD;
+
+				if (SYSCPU != 0)
+					cpu %= SYSCPU;
+
+				m_cpuMap.push_back(cpu);
+			}
+		}
+
+		// each worker constructs its own state on its pinned thread
+		m_providers.resize(m_cpuMap.size());
+		StartWorkers();
+
+		m_isAvailable = true;
+
+		for (size_t i = 0; i < m_providers.size(); ++i)
+		{
+			if (!m_providers[i]->IsAvailable())
+			{
+				m_isAvailable = false;
+				break;
+			}
+		}
+	}
+
+	void ParallelCJP::PinThread(size_t CpuIndex)
+	{
+#if defined(CEX_OS_WINDOWS)
+		if (CpuIndex < sizeof(DWORD_PTR) * 8)
+			SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << CpuIndex);
+#elif defined(CEX_OS_LINUX)
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(CpuIndex, &cpuSet);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet);
+#else
+		// affinity is advisory; platforms without an affinity api run unpinned
+		(void)CpuIndex;
+#endif
+	}
+
+	void ParallelCJP::RunWorker(size_t Index)
+	{
+		// pinned once for the life of the thread; the state is built here so its noise buffer is placed and first touched on this processor
+		if (m_pinThreads)
+			PinThread(m_cpuMap[Index]);
+
+		std::exception_ptr error;
+		uint64_t generation = 0;
+
+		try
+		{
+			if (!m_providers[Index])
+				m_providers[Index].reset(new CJP());
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_taskLock);
+
+			generation = m_taskGeneration;
+			m_errors[Index] = error;
+
+			if (--m_pendingTasks == 0)
+				m_doneSignal.notify_all();
+		}
+
+		while (true)
+		{
+			WorkerTask task;
+
+			{
+				std::unique_lock<std::mutex> lock(m_taskLock);
+				m_taskSignal.wait(lock, [this, generation]() { return m_stopWorkers || m_taskGeneration != generation; });
+
+				if (m_stopWorkers)
+					return;
+
+				generation = m_taskGeneration;
+				task = m_tasks[Index];
+			}
+
+			if (!task.Active)
+				continue;
+
+			error = nullptr;
+
+			try
+			{
+				if (task.Reset)
+					m_providers[Index]->Reset();
+				else
+					m_providers[Index]->GetBytes(task.Output, task.Length);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(m_taskLock);
+			m_errors[Index] = error;
+
+			if (--m_pendingTasks == 0)
+				m_doneSignal.notify_all();
+		}
+	}
+
+	void ParallelCJP::StartWorkers()
+	{
+		const size_t WRKCNT = m_providers.size();
+		std::exception_ptr error;
+
+		m_errors.assign(WRKCNT, nullptr);
+		m_tasks.assign(WRKCNT, WorkerTask());
+		m_stopWorkers = false;
+		m_pendingTasks = WRKCNT;
+
+		for (size_t i = 0; i < WRKCNT; ++i)
+			m_workers.push_back(std::thread(&ParallelCJP::RunWorker, this, i));
+
+		// wait until every worker has pinned itself and built its state
+		{
+			std::unique_lock<std::mutex> lock(m_taskLock);
+			m_doneSignal.wait(lock, [this]() { return m_pendingTasks == 0; });
+
+			for (size_t i = 0; i < WRKCNT && !error; ++i)
+				error = m_errors[i];
+		}
+
+		if (error)
+		{
+			StopWorkers();
+			std::rethrow_exception(error);
+		}
+	}
+
+	void ParallelCJP::StopWorkers()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_taskLock);
+			m_stopWorkers = true;
+		}
+
+		m_taskSignal.notify_all();
+
+		for (size_t i = 0; i < m_workers.size(); ++i)
+		{
+			if (m_workers[i].joinable())
+				m_workers[i].join();
+		}
+
+		m_workers.clear();
+	}
+
+	void ParallelCJP::UpdateSettings()
+	{
+		for (size_t i = 0; i < m_providers.size(); ++i)
+		{
+			m_providers[i]->EnableAccess() = m_enableAccess;
+			m_providers[i]->EnableDebias() = m_enableDebias;
+			m_providers[i]->EnableEstimator() = m_enableEstimator;
+			m_providers[i]->Extractor() = m_extractor;
+			m_providers[i]->HarvestBits() = m_harvestBits;
+			m_providers[i]->MemoryPages() = m_memPages;
+			m_providers[i]->MemoryPlacement() = m_memPlacement;
+			m_providers[i]->MemoryTarget() = m_memTarget;
+			m_providers[i]->OverSampleRate() = m_overSampleRate;
+			m_providers[i]->SecureCache() = m_secureCache;
+		}
+	}
+}
@@ -0,0 +1,333 @@
+#ifndef _CEXENGINE_PARALLELCJP_H
+#define _CEXENGINE_PARALLELCJP_H
+
+#include "Config.h"
+#include "CJP.h"
+#include "CpuDetect.h"
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The placement of the ParallelCJP workers on the processor topology
+	/// </summary>
+	enum class WorkerPlacements : int
+	{
+		/// <summary>
+		/// One worker per physical core; the SMT siblings are only used when there are more workers than cores
+		/// </summary>
+		Cores = 0,
+		/// <summary>
+		/// Workers fill every SMT sibling of a core before moving to the next core, so that sibling pairs contend for the core's caches and execution units
+		/// </summary>
+		Siblings = 1
+	};
+
+	/// <summary>
+	/// A multi-core CPU Jitter entropy Provider.
+	/// <para>Runs one persistent worker thread per processor in the map. Each worker is pinned to its processor once, when it starts, and constructs and owns its own CJP state there,
+	/// so the state's noise buffer is first touched on the worker's processor. A large request is split into disjoint slices of the output buffer that the workers fill concurrently;
+	/// the calling thread only dispatches and waits. Requests smaller than ParallelMinimum are generated by the first worker alone.
+	/// Requests and Reset calls from several threads are serialized; each one waits until the workers have finished the one before it.</para>
+	/// </summary>
+	///
+	/// <example>
+	/// <description>Example of filling a large buffer:</description>
+	/// <code>
+	/// std:vector&lt;uint8_t&gt; output(1024 * 1000);
+	/// ParallelCJP gen;
+	/// gen.GetBytes(output);
+	/// </code>
+	/// </example>
+	class ParallelCJP
+	{
+	private:
+		const size_t PARALLEL_MINSIZE = 1024;
+		const size_t WORD_SIZE = sizeof(uint64_t);
+
+		struct WorkerTask
+		{
+			bool Active;
+			size_t Length;
+			byte* Output;
+			bool Reset;
+		};
+
+		std::vector<size_t> m_cpuMap;
+		std::mutex m_dispatchLock;
+		std::condition_variable m_doneSignal;
+		bool m_enableAccess;
+		bool m_enableDebias;
+		bool m_enableEstimator;
+		std::vector<std::exception_ptr> m_errors;
+		Extractors m_extractor;
+		uint32_t m_harvestBits;
+		bool m_isAvailable;
+		HugePages m_memPages;
+		NumaPlacements m_memPlacement;
+		MemoryTargets m_memTarget;
+		uint32_t m_overSampleRate;
+		size_t m_parallelMinSize;
+		size_t m_pendingTasks;
+		bool m_pinThreads;
+		WorkerPlacements m_placement;
+		CpuDetect::CoreTypes m_preferredCores;
+		std::vector<std::unique_ptr<CJP>> m_providers;
+		bool m_secureCache;
+		bool m_stopWorkers;
+		uint64_t m_taskGeneration;
+		std::mutex m_taskLock;
+		std::vector<WorkerTask> m_tasks;
+		std::condition_variable m_taskSignal;
+		std::vector<std::thread> m_workers;
+
+	public:
+
+		ParallelCJP(const ParallelCJP&) = delete;
+		ParallelCJP& operator=(const ParallelCJP&) = delete;
+		ParallelCJP& operator=(ParallelCJP&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get/Set: Enable the memory access noise source on every worker
+		/// </summary>
+		bool &EnableAccess() { return m_enableAccess; }
+
+		/// <summary>
+		/// Get/Set: Enable the Von Neumann debiasing extractor on every worker
+		/// </summary>
+		bool &EnableDebias() { return m_enableDebias; }
+
+		/// <summary>
+		/// Get/Set: Run the streaming min-entropy estimators on every worker; disabled by default, a change reaches the workers with the next request or Reset
+		/// </summary>
+		bool &EnableEstimator() { return m_enableEstimator; }
+
+		/// <summary>
+		/// Get: The smallest of each min-entropy estimate over the workers; every worker keeps its own window, the core with the least jitter sets the figure
+		/// </summary>
+		const EntropyEstimate Estimate();
+
+		/// <summary>
+		/// Get/Set: The debiasing extractor used by every worker; the default is Von Neumann
+		/// </summary>
+		Extractors &Extractor() { return m_extractor; }
+
+		/// <summary>
+		/// Get/Set: The entropy bits credited per timing measurement on every worker; values above 1 enable harvest mode, see CJP::HarvestBits
+		/// </summary>
+		uint32_t &HarvestBits() { return m_harvestBits; }
+
+		/// <summary>
+		/// Get: The entropy provider is available on this system.
+		/// <para>True only if every worker state passed the timer qualification and none has failed a continuous health test.</para>
+		/// </summary>
+		const bool IsAvailable()
+		{
+			for (size_t i = 0; i < m_providers.size(); ++i)
+			{
+				if (!m_providers[i]->IsAvailable())
+					return false;
+			}
+
+			return m_isAvailable;
+		}
+
+		/// <summary>
+		/// Get/Set: The page backing of every worker's memory noise buffer; takes effect at the next Reset
+		/// </summary>
+		HugePages &MemoryPages() { return m_memPages; }
+
+		/// <summary>
+		/// Get/Set: The NUMA node placement of every worker's memory noise buffer; the default is NumaPlacements::Local.
+		/// <para>Each worker builds its buffer on its own thread, so with PinThreads set on a multi-node host Local places the buffer on the worker's own node
+		/// and Remote on the most distant node. A change takes effect at the next Reset.</para>
+		/// </summary>
+		NumaPlacements &MemoryPlacement() { return m_memPlacement; }
+
+		/// <summary>
+		/// Get/Set: The memory level targeted by every worker's memory noise source; the default is MemoryTargets::L2, a change takes effect at the next Reset
+		/// </summary>
+		MemoryTargets &MemoryTarget() { return m_memTarget; }
+
+		/// <summary>
+		/// Get: Provider name
+		/// </summary>
+		const char* Name() { return "ParallelCJP"; }
+
+		/// <summary>
+		/// Get/Set: The number of overlapping passes through the jitter entropy collector on every worker
+		/// </summary>
+		uint32_t &OverSampleRate() { return m_overSampleRate; }
+
+		/// <summary>
+		/// Get/Set: The smallest request in bytes that is split across the workers; the default is 1024 bytes.
+		/// <para>Smaller requests are generated by the first worker alone.</para>
+		/// </summary>
+		size_t &ParallelMinimum() { return m_parallelMinSize; }
+
+		/// <summary>
+		/// Get/Set: Pin each worker thread to its assigned processor; enabled by default.
+		/// <para>The workers are pinned when they start; a change takes effect at the next Reset, which restarts them.</para>
+		/// </summary>
+		bool &PinThreads() { return m_pinThreads; }
+
+		/// <summary>
+		/// Get: The placement of the workers on the processor topology
+		/// </summary>
+		const WorkerPlacements Placement() { return m_placement; }
+
+		/// <summary>
+		/// Get: The core type given the first workers on a hybrid processor
+		/// </summary>
+		const CpuDetect::CoreTypes PreferredCores() { return m_preferredCores; }
+
+		/// <summary>
+		/// Get: The number of worker states owned by this instance
+		/// </summary>
+		const size_t ProcessorCount() { return m_providers.size(); }
+
+		/// <summary>
+		/// Get: The logical processor assigned to each worker, in worker order
+		/// </summary>
+		const std::vector<size_t> ProcessorMap() { return m_cpuMap; }
+
+		/// <summary>
+		/// Get: The largest OverSampleRate required by any worker; 0 until every worker has a full estimator window, see CJP::RequiredOverSampleRate
+		/// </summary>
+		const uint32_t RequiredOverSampleRate();
+
+		/// <summary>
+		/// Get/Set: Populate the random cache of every worker with an unused value after each generation cycle
+		/// </summary>
+		bool &SecureCache() { return m_secureCache; }
+
+		/// <summary>
+		/// Get: The hot path counters summed over the workers; all zero unless built with CEX_CJP_STATISTICS, see CJP::Statistics
+		/// </summary>
+		const JitterStatistics Statistics();
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate this class
+		/// </summary>
+		///
+		/// <param name="ProcessorCount">The number of workers; the default value of zero uses one worker per physical core, or one per logical processor with WorkerPlacements::Siblings</param>
+		/// <param name="Placement">The placement of the workers on the processors the process may run on</param>
+		/// <param name="PreferredCores">On a hybrid processor, the core type that is given workers first; the default prefers the performance cores, whose faster clock takes more measurements per nanosecond. Unknown keeps the processor order</param>
+		explicit ParallelCJP(size_t ProcessorCount = 0, WorkerPlacements Placement = WorkerPlacements::Cores, CpuDetect::CoreTypes PreferredCores = CpuDetect::CoreTypes::Performance)
+			:
+			m_cpuMap(0),
+			m_dispatchLock(),
+			m_doneSignal(),
+			m_enableAccess(true),
+			m_enableDebias(true),
+			m_enableEstimator(false),
+			m_errors(0),
+			m_extractor(Extractors::VonNeumann),
+			m_harvestBits(1),
+			m_isAvailable(false),
+			m_memPages(HugePages::None),
+			m_memPlacement(NumaPlacements::Local),
+			m_memTarget(MemoryTargets::L2),
+			m_overSampleRate(1),
+			m_parallelMinSize(PARALLEL_MINSIZE),
+			m_pendingTasks(0),
+			m_pinThreads(true),
+			m_placement(Placement),
+			m_preferredCores(PreferredCores),
+			m_providers(0),
+			m_secureCache(true),
+			m_stopWorkers(false),
+			m_taskGeneration(0),
+			m_taskLock(),
+			m_tasks(0),
+			m_taskSignal(),
+			m_workers(0)
+		{
+			Initialize(ProcessorCount);
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~ParallelCJP()
+		{
+			Destroy();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Stop the worker threads and release all resources associated with the object
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Fill a buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		void GetBytes(std::vector<byte> &Output);
+
+		/// <summary>
+		/// Fill the buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		/// <param name="Offset">The starting position within the Output array</param>
+		/// <param name="Length">The number of bytes to write to the Output array</param>
+		void GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length);
+
+		/// <summary>
+		/// Fill a caller owned memory region with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">Pointer to the first byte of the output region</param>
+		/// <param name="Length">The number of bytes to write to the Output region</param>
+		void GetBytes(byte* Output, size_t Length);
+
+		/// <summary>
+		/// Return an array with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Length">The size of the expected array returned</param>
+		///
+		/// <returns>An array of pseudo-random of bytes</returns>
+		std::vector<byte> GetBytes(size_t Length);
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer
+		/// </summary>
+		uint32_t Next();
+
+		/// <summary>
+		/// Reset the internal state of every worker; the workers are restarted first, so a changed PinThreads setting is applied
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Zero the hot path counters of every worker
+		/// </summary>
+		void ResetStatistics();
+
+	private:
+
+		void Dispatch(const std::vector<WorkerTask> &Tasks);
+		void Generate(byte* Output, size_t Length);
+		void Initialize(size_t ProcessorCount);
+		static void PinThread(size_t CpuIndex);
+		void RunWorker(size_t Index);
+		void StartWorkers();
+		void StopWorkers();
+		void UpdateSettings();
+	};
+
+}
+#endif
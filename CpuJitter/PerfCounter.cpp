@@ -0,0 +1,223 @@
+#include "PerfCounter.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(CEX_PERF_RDPMC)
+#	include <linux/perf_event.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+namespace CpuJitter
+{
+#if defined(CEX_PERF_RDPMC)
+	namespace
+	{
+		// the group members, in open order; the cycle counter leads the group
+		const size_t CYCLES = 0;
+		const size_t CACHE_MISSES = 1;
+		const size_t BRANCH_MISSES = 2;
+		const size_t EVENT_COUNT = 3;
+		const uint64_t EVENT_CONFIGS[EVENT_COUNT] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES };
+
+		inline uint64_t Rdpmc(uint32_t Counter)
+		{
+			uint32_t high;
+			uint32_t low;
+
+			__asm__ __volatile__("rdpmc" : "=a"(low), "=d"(high) : "c"(Counter));
+
+			return (static_cast<uint64_t>(high) << 32) | low;
+		}
+
+		uint64_t ReadPage(const volatile perf_event_mmap_page* Page)
+		{
+			// the self-monitoring protocol of linux/perf_event.h; the kernel bumps the lock around every update of the page,
+			// so a read that saw the lock change is repeated. An index of zero means the counter is not scheduled, the offset then holds the whole count
+			uint64_t count;
+			uint32_t seq;
+
+			do
+			{
+				seq = Page->lock;
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+				const uint32_t IDX = Page->index;
+				count = Page->offset;
+
+				if (Page->cap_user_rdpmc && IDX != 0)
+				{
+					// the counter is pmc_width bits wide; sign extend it before adding it to the offset
+					const uint32_t SHIFT = 64 - Page->pmc_width;
+					const int64_t PMC = static_cast<int64_t>(Rdpmc(IDX - 1) << SHIFT) >> SHIFT;
+					count += static_cast<uint64_t>(PMC);
+				}
+
+				std::atomic_signal_fence(std::memory_order_seq_cst);
+			}
+			while (Page->lock != seq);
+
+			return count;
+		}
+
+		class CounterGroup
+		{
+		private:
+			int m_fds[EVENT_COUNT];
+			volatile perf_event_mmap_page* m_pages[EVENT_COUNT];
+			size_t m_pageSize;
+
+		public:
+
+			CounterGroup()
+				:
+				m_pageSize(static_cast<size_t>(sysconf(_SC_PAGESIZE)))
+			{
+				for (size_t i = 0; i < EVENT_COUNT; ++i)
+				{
+					m_fds[i] = -1;
+					m_pages[i] = 0;
+				}
+
+				Open();
+			}
+
+			~CounterGroup()
+			{
+				// members are closed before the leader
+				for (size_t i = EVENT_COUNT; i-- > 0;)
+					Close(i);
+			}
+
+			uint64_t Read(size_t Event) const
+			{
+				return (m_pages[Event] != 0) ? ReadPage(m_pages[Event]) : 0;
+			}
+
+			bool Readable(size_t Event) const
+			{
+				return m_pages[Event] != 0;
+			}
+
+		private:
+
+			void Close(size_t Event)
+			{
+				if (m_pages[Event] != 0)
+				{
+					munmap(const_cast<perf_event_mmap_page*>(m_pages[Event]), m_pageSize);
+					m_pages[Event] = 0;
+				}
+
+				if (m_fds[Event] != -1)
+				{
+					close(m_fds[Event]);
+					m_fds[Event] = -1;
+				}
+			}
+
+			void Open()
+			{
+				for (size_t i = 0; i < EVENT_COUNT; ++i)
+				{
+					perf_event_attr attr;
+					memset(&attr, 0, sizeof(attr));
+					attr.type = PERF_TYPE_HARDWARE;
+					attr.size = sizeof(attr);
+					attr.config = EVENT_CONFIGS[i];
+					attr.exclude_hv = 1;
+					// user mode only; permitted at the default perf_event_paranoid level of 2
+					attr.exclude_kernel = 1;
+
+					// the calling thread on any processor; the members are scheduled together with the leader
+					const int GRPFD = (i == CYCLES) ? -1 : m_fds[CYCLES];
+					m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, GRPFD, 0));
+
+					if (m_fds[i] == -1)
+					{
+						// without the leader there is no group
+						if (i == CYCLES)
+							return;
+
+						continue;
+					}
+
+					void* page = mmap(0, m_pageSize, PROT_READ, MAP_SHARED, m_fds[i], 0);
+
+					if (page != MAP_FAILED)
+						m_pages[i] = static_cast<perf_event_mmap_page*>(page);
+
+					// a counter the kernel will not expose to RDPMC would need a read system call per sample; it is not used
+					if (m_pages[i] == 0 || !m_pages[i]->cap_user_rdpmc)
+					{
+						if (i == CYCLES)
+						{
+							Close(CYCLES);
+							return;
+						}
+
+						Close(i);
+					}
+				}
+			}
+		};
+
+		CounterGroup &ThreadGroup()
+		{
+			// one group per thread, opened on the thread's first read; a counter is only valid on the thread that opened it
+			thread_local CounterGroup group;
+
+			return group;
+		}
+	}
+#endif
+
+	//~~~Public Methods~~~//
+
+	bool PerfCounter::Available()
+	{
+#if defined(CEX_PERF_RDPMC)
+		return ThreadGroup().Readable(CYCLES);
+#else
+		return false;
+#endif
+	}
+
+	uint64_t PerfCounter::BranchMisses()
+	{
+#if defined(CEX_PERF_RDPMC)
+		return ThreadGroup().Read(BRANCH_MISSES);
+#else
+		return 0;
+#endif
+	}
+
+	uint64_t PerfCounter::CacheMisses()
+	{
+#if defined(CEX_PERF_RDPMC)
+		return ThreadGroup().Read(CACHE_MISSES);
+#else
+		return 0;
+#endif
+	}
+
+	uint64_t PerfCounter::Cycles()
+	{
+#if defined(CEX_PERF_RDPMC)
+		return ThreadGroup().Read(CYCLES);
+#else
+		return 0;
+#endif
+	}
+
+	bool PerfCounter::EventsAvailable()
+	{
+#if defined(CEX_PERF_RDPMC)
+		const CounterGroup &GROUP = ThreadGroup();
+
+		return GROUP.Readable(CACHE_MISSES) && GROUP.Readable(BRANCH_MISSES);
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,58 @@
+#ifndef _CEXENGINE_PERFCOUNTER_H
+#define _CEXENGINE_PERFCOUNTER_H
+
+#include "Config.h"
+
+#if defined(CEX_OS_LINUX) && (defined(__x86_64__) || defined(__i386__))
+#	define CEX_PERF_RDPMC
+#endif
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// Self-monitoring hardware performance counters, read in user space.
+	/// <para>On linux x86 each thread that reads a counter opens its own perf_event group on first use: core cycles as the leader, with cache misses and branch misses as members,
+	/// counting user mode only. Each counter's mmap'd page is read with RDPMC under the page's sequence lock, so a read costs no system call.
+	/// The group stays open until the thread exits. A counter is not available if the events are restricted (perf_event_paranoid, a container seccomp profile),
+	/// if the host has no hardware PMU (most virtual machines), or if the kernel has disabled user space RDPMC; a read then returns zero.
+	/// Other platforms report no counters.</para>
+	/// </summary>
+	class PerfCounter
+	{
+	public:
+
+		/// <summary>
+		/// The cycle counter can be opened and read in user space on the calling thread; opens the thread's counter group if it is not open yet
+		/// </summary>
+		static bool Available();
+
+		/// <summary>
+		/// Read the calling thread's branch miss counter
+		/// </summary>
+		///
+		/// <returns>The user mode branch misses since the group was opened, or zero if the counter is not available</returns>
+		static uint64_t BranchMisses();
+
+		/// <summary>
+		/// Read the calling thread's last level cache miss counter
+		/// </summary>
+		///
+		/// <returns>The user mode cache misses since the group was opened, or zero if the counter is not available</returns>
+		static uint64_t CacheMisses();
+
+		/// <summary>
+		/// Read the calling thread's core cycle counter.
+		/// <para>Core cycles follow the processor frequency and stop while the thread is descheduled, so the ticks can not be converted to time.</para>
+		/// </summary>
+		///
+		/// <returns>The user mode core cycles since the group was opened, or zero if the counter is not available</returns>
+		static uint64_t Cycles();
+
+		/// <summary>
+		/// The cache miss and branch miss counters can be opened and read in user space on the calling thread
+		/// </summary>
+		static bool EventsAvailable();
+	};
+
+}
+#endif
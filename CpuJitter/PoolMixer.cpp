@@ -0,0 +1,289 @@
+#include "PoolMixer.h"
+#include "CpuDetect.h"
+#include "IsaDispatch.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#	define CEX_MIXER_X64
+#	if defined(CEX_OS_WINDOWS)
+#		include <intrin.h>
+#	else
+#		include <immintrin.h>
+#	endif
+#endif
+
+namespace CpuJitter
+{
+	namespace
+	{
+		// the first two SHA-1 initialization vectors, FIPS 180-4 section 5.3.1
+		const uint64_t STIR_CONSTANT = 0x67452301EFCDAB89ULL;
+		// the third and fourth SHA-1 initialization vectors; the start value of the mixer
+		const uint64_t STIR_MIXER = 0x98BADCFE10325476ULL;
+
+		// the contribution of pool bit i to the mixer is the constant rotated right by i
+		struct StirTable
+		{
+			uint64_t Values[64];
+
+			StirTable()
+			{
+				for (size_t i = 0; i < 64; ++i)
+					Values[i] = (i == 0) ? STIR_CONSTANT : (STIR_CONSTANT >> i) | (STIR_CONSTANT << (64 - i));
+			}
+		};
+
+		const StirTable &Table()
+		{
+			static const StirTable TABLE;
+			return TABLE;
+		}
+
+		// known answers of the reference loop: { pool, stirred pool }
+		const uint64_t STIR_KAT[][2] =
+		{
+			{ 0x0000000000000000ULL, 0x98BADCFE10325476ULL },
+			{ 0x0000000000000001ULL, 0xFFFFFFFFFFFFFFFEULL },
+			{ 0x8000000000000000ULL, 0xD6309AFDCFA90364ULL },
+			{ 0xFFFFFFFFFFFFFFFFULL, 0x67452301EFCDAB89ULL },
+			{ 0x0123456789ABCDEFULL, 0x8989898989898989ULL },
+			{ 0xDEADBEEFCAFEBABEULL, 0xED09EB25BD1EAB30ULL }
+		};
+
+		// known answers of the bit serial LFSR: { pool, bits, count, updated pool }
+		const uint64_t LFSR_KAT[][4] =
+		{
+			{ 0x0000000000000000ULL, 0x0000000000000001ULL, 1, 0x0000000000000002ULL },
+			{ 0x8000000000000000ULL, 0x0000000000000000ULL, 1, 0x0000000000000003ULL },
+			{ 0x0123456789ABCDEFULL, 0x00000000000000A5ULL, 8, 0x23456789ABCDEE7BULL },
+			{ 0xDEADBEEFCAFEBABEULL, 0x03FFFFFFFFFFFFFFULL, 58, 0xFF674FD1D5ECE89AULL }
+		};
+
+		uint64_t NextTestValue(uint64_t &State)
+		{
+			// xorshift64; a deterministic sweep for the equivalence tests
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+
+			return State;
+		}
+	}
+
+	//~~~Public Methods~~~//
+
+	PoolMixer::StirFunction PoolMixer::Function(MixKernels Kernel)
+	{
+		switch (Kernel)
+		{
+			case MixKernels::Auto:
+				return Function(Select());
+			case MixKernels::Scalar:
+				return &StirScalar;
+			case MixKernels::Portable:
+				return &StirPortable;
+#if defined(CEX_MIXER_X64)
+			case MixKernels::Avx2:
+			case MixKernels::Clmul:
+			{
+				try
+				{
+					std::shared_ptr<CpuDetect> detect = CpuDetect::Snapshot();
+
+					// the cpuid bit alone is not enough; the os must also save the ymm state, or the first vex instruction faults
+					if (Kernel == MixKernels::Avx2 && detect->AVX2() && IsaDispatch::Detected() >= IsaTiers::Avx2)
+						return &StirAvx2;
+					if (Kernel == MixKernels::Clmul && detect->PCLMUL())
+						return &StirClmul;
+				}
+				catch (...)
+				{
+				}
+
+				return 0;
+			}
+#endif
+			default:
+				return 0;
+		}
+	}
+
+	uint64_t PoolMixer::LfsrScalar(uint64_t State, uint64_t Bits, size_t Count)
+	{
+		for (size_t i = 0; i < Count; ++i)
+		{
+			// Fibonacci LSFR with polynom of 64, 63, 61, 60; identical to the bit serial MixBit step of the providers
+			State ^= (Bits >> i) & 1;
+			State ^= ((State >> 63) & 1);
+			State ^= ((State >> 62) & 1);
+			State ^= ((State >> 60) & 1);
+			State ^= ((State >> 59) & 1);
+			State = RotL64(State, 1);
+		}
+
+		return State;
+	}
+
+	const char* PoolMixer::Name(MixKernels Kernel)
+	{
+		switch (Kernel)
+		{
+			case MixKernels::Auto:
+				return "Auto";
+			case MixKernels::Scalar:
+				return "Scalar";
+			case MixKernels::Portable:
+				return "Portable";
+			case MixKernels::Avx2:
+				return "AVX2";
+			case MixKernels::Clmul:
+				return "CLMUL";
+			default:
+				return "Unknown";
+		}
+	}
+
+	MixKernels PoolMixer::Select()
+	{
+		struct Selection
+		{
+			MixKernels Kernel;
+
+			Selection()
+				:
+				Kernel(MixKernels::Scalar)
+			{
+				// fastest first, each at the tier it requires; a kernel that fails its known answers is never used
+				KernelTable<MixKernels> kernels(MixKernels::Scalar);
+				kernels.Add(IsaTiers::Sse, MixKernels::Clmul).Add(IsaTiers::Avx2, MixKernels::Avx2).Add(IsaTiers::Scalar, MixKernels::Portable);
+
+				Kernel = kernels.Resolve([](MixKernels Variant) { return SelfTest(Variant); });
+			}
+		};
+
+		static const Selection SELECTED;
+
+		return SELECTED.Kernel;
+	}
+
+	bool PoolMixer::SelfTest(MixKernels Kernel)
+	{
+		const StirFunction STIR = (Kernel == MixKernels::Auto) ? 0 : Function(Kernel);
+
+		if (STIR == 0)
+			return false;
+
+		for (size_t i = 0; i < sizeof(STIR_KAT) / sizeof(STIR_KAT[0]); ++i)
+		{
+			if (STIR(STIR_KAT[i][0]) != STIR_KAT[i][1])
+				return false;
+		}
+
+		for (size_t i = 0; i < sizeof(LFSR_KAT) / sizeof(LFSR_KAT[0]); ++i)
+		{
+			const size_t CNT = static_cast<size_t>(LFSR_KAT[i][2]);
+
+			if (LfsrScalar(LFSR_KAT[i][0], LFSR_KAT[i][1], CNT) != LFSR_KAT[i][3] || LfsrBlock(LFSR_KAT[i][0], LFSR_KAT[i][1], CNT) != LFSR_KAT[i][3])
+				return false;
+		}
+
+		// equivalence with the references over a pseudo-random sweep, including every block length
+		uint64_t seed = 0x9E3779B97F4A7C15ULL;
+
+		for (size_t i = 0; i < 256; ++i)
+		{
+			const uint64_t POOL = NextTestValue(seed);
+			const uint64_t BITS = NextTestValue(seed);
+			const size_t CNT = (i % LFSR_BLOCK_MAX) + 1;
+
+			if (STIR(POOL) != StirScalar(POOL) || LfsrBlock(POOL, BITS, CNT) != LfsrScalar(POOL, BITS, CNT))
+				return false;
+		}
+
+		return true;
+	}
+
+	uint64_t PoolMixer::StirScalar(uint64_t State)
+	{
+		// shuffle the pool by mixing some value with a bijective function (XOR) into the pool
+		// this function generates a mixer value that depends on the bits set and the
+		// location of the set bits in the random number generated by the entropy source.
+		// the mixer value is not assumed to contain any entropy,
+		// but due to the XOR operation, it can also not destroy any entropy present in the entropy pool.
+		uint64_t mixer = STIR_MIXER;
+
+		for (size_t i = 0; i < 64; ++i)
+		{
+			// get the i-th bit of the input random number and only XOR the constant into the mixer value when that bit is set
+			if ((State >> i) & 1)
+				mixer ^= STIR_CONSTANT;
+
+			mixer = RotL64(mixer, 1);
+		}
+
+		return State ^ mixer;
+	}
+
+	//~~~Private Methods~~~//
+
+#if defined(CEX_MIXER_X64)
+	CEX_TARGET_ISA("avx2")
+	uint64_t PoolMixer::StirAvx2(uint64_t State)
+	{
+		// four pool bits per step; each lane turns its bit into a full width mask over its rotated constant
+		const uint64_t* TBL = Table().Values;
+		const __m256i ONE = _mm256_set1_epi64x(1);
+		const __m256i POOL = _mm256_set1_epi64x(static_cast<long long>(State));
+		__m256i shift = _mm256_set_epi64x(3, 2, 1, 0);
+		const __m256i STEP = _mm256_set1_epi64x(4);
+		__m256i acc = _mm256_setzero_si256();
+
+		for (size_t i = 0; i < 64; i += 4)
+		{
+			const __m256i BIT = _mm256_and_si256(_mm256_srlv_epi64(POOL, shift), ONE);
+			const __m256i MASK = _mm256_sub_epi64(_mm256_setzero_si256(), BIT);
+
+			acc = _mm256_xor_si256(acc, _mm256_and_si256(MASK, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(TBL + i))));
+			shift = _mm256_add_epi64(shift, STEP);
+		}
+
+		const __m128i HALF = _mm_xor_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+		const uint64_t MIXER = static_cast<uint64_t>(_mm_cvtsi128_si64(HALF)) ^ static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(HALF, HALF)));
+
+		return State ^ STIR_MIXER ^ MIXER;
+	}
+
+	CEX_TARGET_ISA("pclmul,sse2")
+	uint64_t PoolMixer::StirClmul(uint64_t State)
+	{
+		// the mixer is the cyclic correlation of the pool with the constant; with the constant bit reversed it becomes
+		// a cyclic carry-less product, the high half of the 127 bit product wraps onto the low half
+		static const uint64_t REVCON = Reverse64(STIR_CONSTANT);
+		const __m128i PROD = _mm_clmulepi64_si128(_mm_cvtsi64_si128(static_cast<long long>(State)), _mm_cvtsi64_si128(static_cast<long long>(REVCON)), 0x00);
+		const uint64_t CYCLIC = static_cast<uint64_t>(_mm_cvtsi128_si64(PROD)) ^ static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(PROD, PROD)));
+
+		return State ^ STIR_MIXER ^ Reverse64(CYCLIC);
+	}
+#else
+	uint64_t PoolMixer::StirAvx2(uint64_t State)
+	{
+		return StirPortable(State);
+	}
+
+	uint64_t PoolMixer::StirClmul(uint64_t State)
+	{
+		return StirPortable(State);
+	}
+#endif
+
+	uint64_t PoolMixer::StirPortable(uint64_t State)
+	{
+		// branch free; the mixer is the sum of the rotated constants selected by the set pool bits
+		const uint64_t* TBL = Table().Values;
+		uint64_t mixer = STIR_MIXER;
+
+		for (size_t i = 0; i < 64; ++i)
+			mixer ^= TBL[i] & (0 - ((State >> i) & 1));
+
+		return State ^ mixer;
+	}
+}
@@ -0,0 +1,145 @@
+#ifndef _CEXENGINE_POOLMIXER_H
+#define _CEXENGINE_POOLMIXER_H
+
+#include "Config.h"
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// The pool stirring kernels
+	/// </summary>
+	enum class MixKernels : int
+	{
+		/// <summary>
+		/// Select the fastest kernel supported by the processor
+		/// </summary>
+		Auto = 0,
+		/// <summary>
+		/// The reference implementation; a 64 iteration loop that conditionally adds the constant per set bit
+		/// </summary>
+		Scalar = 1,
+		/// <summary>
+		/// A branch free table reduction over the rotated constant
+		/// </summary>
+		Portable = 2,
+		/// <summary>
+		/// The table reduction on four 64bit lanes with AVX2
+		/// </summary>
+		Avx2 = 3,
+		/// <summary>
+		/// A single carry-less multiplication with PCLMULQDQ
+		/// </summary>
+		Clmul = 4
+	};
+
+	/// <summary>
+	/// The deterministic pool mixing functions of the jitter providers, with processor specific kernels selected at runtime.
+	/// <para>The stirring mixer is the cyclic carry-less product of the pool with a constant; every kernel computes the same function as the scalar reference.
+	/// The LFSR block step feeds several bits at once, which is exact because the feedback taps never read a bit written in the previous 58 steps.
+	/// Only the deterministic mixing is accelerated, the timing sensitive noise loops are not affected.</para>
+	/// </summary>
+	class PoolMixer
+	{
+	public:
+
+		/// <summary>
+		/// A pool stirring function; returns the stirred pool
+		/// </summary>
+		typedef uint64_t(*StirFunction)(uint64_t);
+
+		/// <summary>
+		/// The largest number of bits LfsrBlock can feed in one step
+		/// </summary>
+		static const size_t LFSR_BLOCK_MAX = 58;
+
+		/// <summary>
+		/// Get the stirring function of a kernel
+		/// </summary>
+		///
+		/// <param name="Kernel">The kernel; Auto returns the kernel chosen by Select</param>
+		///
+		/// <returns>The stirring function, or null if the kernel is not supported by the processor, the operating system or the build</returns>
+		static StirFunction Function(MixKernels Kernel);
+
+		/// <summary>
+		/// Feed bits into the 64, 63, 61, 60 Fibonacci LFSR one at a time; the reference implementation
+		/// </summary>
+		///
+		/// <param name="State">The pool</param>
+		/// <param name="Bits">The input bits, bit 0 is fed first</param>
+		/// <param name="Count">The number of bits to feed</param>
+		///
+		/// <returns>The updated pool</returns>
+		static uint64_t LfsrScalar(uint64_t State, uint64_t Bits, size_t Count);
+
+		/// <summary>
+		/// Get the display name of a kernel
+		/// </summary>
+		static const char* Name(MixKernels Kernel);
+
+		/// <summary>
+		/// Get the fastest kernel supported by this processor that passes its known answer tests; detected once per process.
+		/// <para>Only kernels within the IsaDispatch tier are considered, so the CEX_CJP_ISA environment variable can force the portable kernel for testing.
+		/// Function still returns any kernel the processor supports.</para>
+		/// </summary>
+		static MixKernels Select();
+
+		/// <summary>
+		/// Run the known answer tests of a kernel and of the LFSR block step
+		/// </summary>
+		///
+		/// <param name="Kernel">The kernel to test</param>
+		///
+		/// <returns>Returns false if the kernel is unsupported, or its output differs from the reference</returns>
+		static bool SelfTest(MixKernels Kernel);
+
+		/// <summary>
+		/// Stir the pool with the reference loop
+		/// </summary>
+		static uint64_t StirScalar(uint64_t State);
+
+		/// <summary>
+		/// Feed up to 58 bits into the 64, 63, 61, 60 Fibonacci LFSR in one branch free step; identical to LfsrScalar
+		/// </summary>
+		///
+		/// <param name="State">The pool</param>
+		/// <param name="Bits">The input bits, bit 0 is fed first</param>
+		/// <param name="Count">The number of bits to feed, 1 to LFSR_BLOCK_MAX</param>
+		///
+		/// <returns>The updated pool</returns>
+		static inline uint64_t LfsrBlock(uint64_t State, uint64_t Bits, size_t Count)
+		{
+			// the bit fed at step j lands at position Count - j, xored with the taps 63, 62, 60 and 59 read j steps back,
+			// which are still original pool bits; the rest of the pool is rotated by Count
+			const uint64_t MASK = ((static_cast<uint64_t>(1) << Count) - 1) << 1;
+			const uint64_t TAPS = (State >> (63 - Count)) ^ (State >> (62 - Count)) ^ (State >> (60 - Count)) ^ (State >> (59 - Count));
+			const uint64_t INPUT = (Reverse64(Bits) >> (64 - Count)) << 1;
+
+			return RotL64(State, Count) ^ ((TAPS ^ INPUT) & MASK);
+		}
+
+	private:
+
+		static uint64_t Reverse64(uint64_t Value)
+		{
+			Value = ((Value >> 1) & 0x5555555555555555ULL) | ((Value & 0x5555555555555555ULL) << 1);
+			Value = ((Value >> 2) & 0x3333333333333333ULL) | ((Value & 0x3333333333333333ULL) << 2);
+			Value = ((Value >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((Value & 0x0F0F0F0F0F0F0F0FULL) << 4);
+			Value = ((Value >> 8) & 0x00FF00FF00FF00FFULL) | ((Value & 0x00FF00FF00FF00FFULL) << 8);
+			Value = ((Value >> 16) & 0x0000FFFF0000FFFFULL) | ((Value & 0x0000FFFF0000FFFFULL) << 16);
+
+			return (Value >> 32) | (Value << 32);
+		}
+
+		static uint64_t RotL64(uint64_t Value, size_t Shift)
+		{
+			return (Shift == 0) ? Value : (Value << Shift) | (Value >> (64 - Shift));
+		}
+
+		static uint64_t StirAvx2(uint64_t State);
+		static uint64_t StirClmul(uint64_t State);
+		static uint64_t StirPortable(uint64_t State);
+	};
+
+}
+#endif
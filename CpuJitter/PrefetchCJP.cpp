@@ -0,0 +1,326 @@
+#include "PrefetchCJP.h"
+#include "CryptoRandomException.h"
+#include <algorithm>
+#include <chrono>
+
+namespace CpuJitter
+{
+	const size_t PrefetchCJP::Buffered()
+	{
+		const size_t WRTPOS = m_writePosition.load(std::memory_order_acquire);
+		const size_t RDPOS = m_readPosition.load(std::memory_order_acquire);
+
+		return (WRTPOS > RDPOS) ? (WRTPOS - RDPOS) * WORD_SIZE : 0;
+	}
+
+	void PrefetchCJP::Destroy()
+	{
+		if (m_isRunning.exchange(false))
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_signalLock);
+			}
+			m_signal.notify_all();
+		}
+
+		if (m_producer.joinable())
+			m_producer.join();
+
+		if (m_ring)
+		{
+			for (size_t i = 0; i < m_ringSize; ++i)
+				m_ring[i].Value = 0;
+
+			m_ring.reset();
+		}
+
+		if (m_generator)
+			m_generator.reset();
+		if (m_fallback)
+			m_fallback.reset();
+
+		m_error = nullptr;
+		m_isAvailable = false;
+		m_highWatermark = 0;
+		m_lowWatermark = 0;
+		m_ringMask = 0;
+		m_ringSize = 0;
+		m_readPosition = 0;
+		m_writePosition = 0;
+	}
+
+	void PrefetchCJP::GetBytes(std::vector<byte> &Output)
+	{
+		ThrowIfFailed();
+
+		if (!m_isAvailable)
+			throw CryptoRandomException("PrefetchCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+
+		if (Output.size() != 0)
+			Generate(&Output[0], Output.size());
+	}
+
+	void PrefetchCJP::GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length)
+	{
+		ThrowIfFailed();
+
+		if (!m_isAvailable)
+			throw CryptoRandomException("PrefetchCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+		if (Offset + Length > Output.size())
+			throw CryptoRandomException("PrefetchCJP:GetBytes", "The array is too small to fulfill this request!");
+
+		if (Length != 0)
+			Generate(&Output[Offset], Length);
+	}
+
+	void PrefetchCJP::GetBytes(byte* Output, size_t Length)
+	{
+		ThrowIfFailed();
+
+		if (!m_isAvailable)
+			throw CryptoRandomException("PrefetchCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+		if (Output == 0 && Length != 0)
+			throw CryptoRandomException("PrefetchCJP:GetBytes", "The output pointer can not be null!");
+
+		if (Length != 0)
+			Generate(Output, Length);
+	}
+
+	std::vector<byte> PrefetchCJP::GetBytes(size_t Length)
+	{
+		ThrowIfFailed();
+
+		if (!m_isAvailable)
+			throw CryptoRandomException("PrefetchCJP:GetBytes", "High resolution timer not available or too coarse for RNG!");
+
+		std::vector<byte> data(Length);
+
+		if (Length != 0)
+			Generate(&data[0], data.size());
+
+		return data;
+	}
+
+	uint32_t PrefetchCJP::Next()
+	{
+		ThrowIfFailed();
+
+		if (!m_isAvailable)
+			throw CryptoRandomException("PrefetchCJP:Next", "High resolution timer not available or too coarse for RNG!");
+
+		uint32_t rnd = 0;
+		Generate(reinterpret_cast<byte*>(&rnd), sizeof(uint32_t));
+
+		return rnd;
+	}
+
+	bool PrefetchCJP::Dequeue(uint64_t &Value)
+	{
+		// bounded multi-consumer dequeue; each slot carries a sequence number, a consumer claims a slot
+		// by advancing the read position with a compare and swap, then releases it back to the producer
+		size_t pos = m_readPosition.load(std::memory_order_relaxed);
+		RingSlot* slot = 0;
+
+		while (true)
+		{
+			slot = &m_ring[pos & m_ringMask];
+			const size_t SEQ = slot->Sequence.load(std::memory_order_acquire);
+			const intptr_t DIF = static_cast<intptr_t>(SEQ) - static_cast<intptr_t>(pos + 1);
+
+			if (DIF == 0)
+			{
+				if (m_readPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (DIF < 0)
+			{
+				// ring is empty
+				return false;
+			}
+			else
+			{
+				pos = m_readPosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		Value = slot->Value;
+
+		if (m_wipeOnRead.load(std::memory_order_relaxed))
+			slot->Value = 0;
+
+		slot->Sequence.store(pos + m_ringMask + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool PrefetchCJP::Enqueue(uint64_t Value)
+	{
+		// single producer; only the producer thread advances the write position
+		const size_t POS = m_writePosition.load(std::memory_order_relaxed);
+		RingSlot* slot = &m_ring[POS & m_ringMask];
+
+		if (slot->Sequence.load(std::memory_order_acquire) != POS)
+			return false;
+
+		slot->Value = Value;
+		slot->Sequence.store(POS + 1, std::memory_order_release);
+		m_writePosition.store(POS + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	void PrefetchCJP::Generate(byte* Output, size_t Length)
+	{
+		byte* const OUTPTR = Output;
+		const size_t OUTLEN = Length;
+		uint64_t rnd = 0;
+
+		while (Length != 0 && Dequeue(rnd))
+		{
+			// a partially used word is discarded rather than returned to the ring
+			const size_t RMD = (Length < WORD_SIZE) ? Length : WORD_SIZE;
+			memcpy(Output, &rnd, RMD);
+			Output += RMD;
+			Length -= RMD;
+		}
+
+		rnd = 0;
+
+		if (Buffered() <= m_lowWatermark * WORD_SIZE)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_signalLock);
+			}
+			m_signal.notify_one();
+		}
+
+		// the ring is drained; generate the remainder synchronously, unless the producer failed while the request was being served
+		if (Length != 0)
+		{
+			try
+			{
+				ThrowIfFailed();
+			}
+			catch (...)
+			{
+				memset(OUTPTR, 0, OUTLEN);
+				throw;
+			}
+
+			std::lock_guard<std::mutex> lock(m_fallbackLock);
+			m_fallback->GetBytes(Output, Length);
+		}
+	}
+
+	void PrefetchCJP::Initialize(size_t RingSize, size_t LowWatermark, size_t HighWatermark)
+	{
+		if (RingSize == 0)
+			RingSize = DEF_RINGSIZE;
+
+		// round the capacity up to a power of two number of words, with room for at least two producer batches
+		size_t words = PRODUCER_BATCH * 2;
+		while (words * WORD_SIZE < RingSize)
+			words <<= 1;
+
+		m_ringSize = words;
+		m_ringMask = words - 1;
+		m_highWatermark = (HighWatermark == 0) ? m_ringSize : (HighWatermark + WORD_SIZE - 1) / WORD_SIZE;
+		m_lowWatermark = (LowWatermark == 0) ? m_ringSize / 4 : LowWatermark / WORD_SIZE;
+
+		if (m_highWatermark > m_ringSize)
+			throw CryptoRandomException("PrefetchCJP:Initialize", "The high watermark can not exceed the ring size!");
+		if (m_lowWatermark >= m_highWatermark)
+			throw CryptoRandomException("PrefetchCJP:Initialize", "The low watermark must be less than the high watermark!");
+
+		m_ring.reset(new RingSlot[m_ringSize]);
+
+		for (size_t i = 0; i < m_ringSize; ++i)
+		{
+			m_ring[i].Sequence.store(i, std::memory_order_relaxed);
+			m_ring[i].Value = 0;
+		}
+
+		m_generator.reset(new CJP());
+		m_fallback.reset(new CJP());
+		m_isAvailable = m_generator->IsAvailable() && m_fallback->IsAvailable();
+
+		if (m_isAvailable)
+		{
+			m_isRunning = true;
+			m_producer = std::thread(&PrefetchCJP::Produce, this);
+		}
+	}
+
+	void PrefetchCJP::Produce()
+	{
+		std::vector<byte> batch(PRODUCER_BATCH * WORD_SIZE);
+
+		while (m_isRunning.load(std::memory_order_acquire))
+		{
+			const size_t BUFWRD = Buffered() / WORD_SIZE;
+
+			if (BUFWRD >= m_highWatermark)
+			{
+				// the ring is full enough; sleep until consumers drain it below the low watermark
+				std::unique_lock<std::mutex> lock(m_signalLock);
+				m_signal.wait_for(lock, std::chrono::milliseconds(10), [this]()
+				{
+					return !m_isRunning.load(std::memory_order_acquire) || Buffered() <= m_lowWatermark * WORD_SIZE;
+				});
+
+				continue;
+			}
+
+			// only as many words as the ring has room for below the high watermark; consumers can only free more slots meanwhile
+			const size_t WRDCNT = (std::min)(PRODUCER_BATCH, m_highWatermark - BUFWRD);
+
+			try
+			{
+				m_generator->GetBytes(&batch[0], WRDCNT * WORD_SIZE);
+			}
+			catch (...)
+			{
+				// the failure is handed to the consumers; no request is served from the synchronous state after it
+				{
+					std::lock_guard<std::mutex> lock(m_errorLock);
+					m_error = std::current_exception();
+				}
+
+				m_isAvailable.store(false, std::memory_order_release);
+				memset(&batch[0], 0, batch.size());
+				break;
+			}
+
+			for (size_t i = 0; i < WRDCNT; ++i)
+			{
+				uint64_t rnd = 0;
+				memcpy(&rnd, &batch[i * WORD_SIZE], WORD_SIZE);
+
+				// a slot can still be held by a consumer that claimed it and has not yet released it; wait for it rather than drop the word
+				while (!Enqueue(rnd))
+				{
+					if (!m_isRunning.load(std::memory_order_acquire))
+						break;
+
+					std::this_thread::yield();
+				}
+
+				rnd = 0;
+			}
+
+			memset(&batch[0], 0, batch.size());
+		}
+	}
+
+	void PrefetchCJP::ThrowIfFailed()
+	{
+		// the producer stores its error before it clears the flag, so the lock is only taken once a request can already see the failure
+		if (m_isAvailable.load(std::memory_order_acquire))
+			return;
+
+		std::lock_guard<std::mutex> lock(m_errorLock);
+
+		if (m_error)
+			std::rethrow_exception(m_error);
+	}
+}
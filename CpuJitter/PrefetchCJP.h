@@ -0,0 +1,206 @@
+#ifndef _CEXENGINE_PREFETCHCJP_H
+#define _CEXENGINE_PREFETCHCJP_H
+
+#include "Config.h"
+#include "CJP.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// A prefetching CPU Jitter entropy Provider.
+	/// <para>A background thread continuously harvests CJP output into a bounded single-producer/multi-consumer lock-free ring,
+	/// so that a request is normally served by copying already harvested words out of the ring.
+	/// The producer refills the ring up to the high watermark and sleeps until consumers drain it below the low watermark.
+	/// When the ring is empty, the remainder of a request is generated synchronously by a second CJP state.
+	/// Ring words are wiped as they are consumed, and each word is handed out at most once.
+	/// If the producer's generator throws, the producer stops and the provider becomes unavailable; the error is rethrown by every later request
+	/// instead of being hidden behind the synchronous state.</para>
+	/// </summary>
+	///
+	/// <example>
+	/// <description>Example of getting a seed value:</description>
+	/// <code>
+	/// std:vector&lt;uint8_t&gt; output(32);
+	/// PrefetchCJP gen(4096);
+	/// gen.GetBytes(output);
+	/// </code>
+	/// </example>
+	class PrefetchCJP
+	{
+	private:
+		const size_t DEF_RINGSIZE = 16384;
+		const size_t PRODUCER_BATCH = 8;
+		const size_t WORD_SIZE = sizeof(uint64_t);
+
+		struct RingSlot
+		{
+			std::atomic<size_t> Sequence;
+			uint64_t Value;
+		};
+
+		std::exception_ptr m_error;
+		std::mutex m_errorLock;
+		std::unique_ptr<CJP> m_fallback;
+		std::mutex m_fallbackLock;
+		std::unique_ptr<CJP> m_generator;
+		size_t m_highWatermark;
+		std::atomic<bool> m_isAvailable;
+		std::atomic<bool> m_isRunning;
+		size_t m_lowWatermark;
+		std::thread m_producer;
+		std::atomic<size_t> m_readPosition;
+		std::unique_ptr<RingSlot[]> m_ring;
+		size_t m_ringMask;
+		size_t m_ringSize;
+		std::condition_variable m_signal;
+		std::mutex m_signalLock;
+		std::atomic<bool> m_wipeOnRead;
+		std::atomic<size_t> m_writePosition;
+
+	public:
+
+		PrefetchCJP(const PrefetchCJP&) = delete;
+		PrefetchCJP& operator=(const PrefetchCJP&) = delete;
+		PrefetchCJP& operator=(PrefetchCJP&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get: The number of harvested bytes currently waiting in the ring
+		/// </summary>
+		const size_t Buffered();
+
+		/// <summary>
+		/// Get: The producer refills the ring until this many bytes are buffered
+		/// </summary>
+		const size_t HighWatermark() { return m_highWatermark * WORD_SIZE; }
+
+		/// <summary>
+		/// Get: The entropy provider is available on this system.
+		/// <para>This value should be tested after class instantiation and before a request for data is made.
+		/// It becomes false if the producer's generator fails, for example on a latched health test failure; every later request then rethrows that error.</para>
+		/// </summary>
+		const bool IsAvailable() { return m_isAvailable.load(std::memory_order_acquire); }
+
+		/// <summary>
+		/// Get: The producer is woken when the ring drains below this many bytes
+		/// </summary>
+		const size_t LowWatermark() { return m_lowWatermark * WORD_SIZE; }
+
+		/// <summary>
+		/// Get: Provider name
+		/// </summary>
+		const char* Name() { return "PrefetchCJP"; }
+
+		/// <summary>
+		/// Get: The ring capacity in bytes
+		/// </summary>
+		const size_t RingSize() { return m_ringSize * WORD_SIZE; }
+
+		/// <summary>
+		/// Get/Set: Zero each ring word as it is consumed; enabled by default. Atomic, so it can be changed while other threads are reading
+		/// </summary>
+		std::atomic<bool> &WipeOnRead() { return m_wipeOnRead; }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate this class and start the producer thread
+		/// </summary>
+		///
+		/// <param name="RingSize">The ring capacity in bytes, rounded up to a power of two number of 64bit words; the default is 16kib</param>
+		/// <param name="LowWatermark">The fill level in bytes below which the producer resumes; the default of zero uses a quarter of the ring</param>
+		/// <param name="HighWatermark">The fill level in bytes at which the producer pauses; the default of zero uses the full ring</param>
+		/// <param name="WipeOnRead">Zero each ring word as it is consumed</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if the watermarks do not fit within the ring</exception>
+		explicit PrefetchCJP(size_t RingSize = 0, size_t LowWatermark = 0, size_t HighWatermark = 0, bool WipeOnRead = true)
+			:
+			m_error(),
+			m_fallback(),
+			m_generator(),
+			m_highWatermark(0),
+			m_isAvailable(false),
+			m_isRunning(false),
+			m_lowWatermark(0),
+			m_readPosition(0),
+			m_ring(),
+			m_ringMask(0),
+			m_ringSize(0),
+			m_wipeOnRead(WipeOnRead),
+			m_writePosition(0)
+		{
+			Initialize(RingSize, LowWatermark, HighWatermark);
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~PrefetchCJP()
+		{
+			Destroy();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Stop the producer thread and release all resources associated with the object
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Fill a buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		void GetBytes(std::vector<byte> &Output);
+
+		/// <summary>
+		/// Fill the buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		/// <param name="Offset">The starting position within the Output array</param>
+		/// <param name="Length">The number of bytes to write to the Output array</param>
+		void GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length);
+
+		/// <summary>
+		/// Fill a caller owned memory region with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">Pointer to the first byte of the output region</param>
+		/// <param name="Length">The number of bytes to write to the Output region</param>
+		void GetBytes(byte* Output, size_t Length);
+
+		/// <summary>
+		/// Return an array with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Length">The size of the expected array returned</param>
+		///
+		/// <returns>An array of pseudo-random of bytes</returns>
+		std::vector<byte> GetBytes(size_t Length);
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer
+		/// </summary>
+		uint32_t Next();
+
+	private:
+
+		bool Dequeue(uint64_t &Value);
+		bool Enqueue(uint64_t Value);
+		void Generate(byte* Output, size_t Length);
+		void Initialize(size_t RingSize, size_t LowWatermark, size_t HighWatermark);
+		void Produce();
+		void ThrowIfFailed();
+	};
+
+}
+#endif
@@ -0,0 +1,565 @@
+#include "SeededCJP.h"
+#include "CpuDetect.h"
+#include "CryptoRandomException.h"
+
+#if defined(CEX_AESNI_AVAILABLE) && (defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386__))
+#	define CEX_SEEDED_AESNI
+#	include <wmmintrin.h>
+#	include <emmintrin.h>
+#endif
+
+namespace CpuJitter
+{
+	//~~~Local Functions~~~//
+
+	namespace
+	{
+		inline uint32_t RotL32(uint32_t Value, uint32_t Shift)
+		{
+			return (Value << Shift) | (Value >> (32 - Shift));
+		}
+
+		inline uint32_t LoadLE32(const byte* Input)
+		{
+			return static_cast<uint32_t>(Input[0]) | (static_cast<uint32_t>(Input[1]) << 8) |
+				(static_cast<uint32_t>(Input[2]) << 16) | (static_cast<uint32_t>(Input[3]) << 24);
+		}
+
+		inline void StoreLE32(uint32_t Value, byte* Output)
+		{
+			Output[0] = static_cast<byte>(Value);
+			Output[1] = static_cast<byte>(Value >> 8);
+			Output[2] = static_cast<byte>(Value >> 16);
+			Output[3] = static_cast<byte>(Value >> 24);
+		}
+
+		inline void QuarterRound(uint32_t &A, uint32_t &B, uint32_t &C, uint32_t &D)
+		{
+			A += B; D ^= A; D = RotL32(D, 16);
+			C += D; B ^= C; B = RotL32(B, 12);
+			A += B; D ^= A; D = RotL32(D, 8);
+			C += D; B ^= C; B = RotL32(B, 7);
+		}
+
+		void ChaChaBlock(const uint32_t* State, byte* Output)
+		{
+			uint32_t x[16];
+
+			for (size_t i = 0; i < 16; ++i)
+				x[i] = State[i];
+
+			for (size_t i = 0; i < 10; ++i)
+			{
+				QuarterRound(x[0], x[4], x[8], x[12]);
+				QuarterRound(x[1], x[5], x[9], x[13]);
+				QuarterRound(x[2], x[6], x[10], x[14]);
+				QuarterRound(x[3], x[7], x[11], x[15]);
+				QuarterRound(x[0], x[5], x[10], x[15]);
+				QuarterRound(x[1], x[6], x[11], x[12]);
+				QuarterRound(x[2], x[7], x[8], x[13]);
+				QuarterRound(x[3], x[4], x[9], x[14]);
+			}
+
+			for (size_t i = 0; i < 16; ++i)
+				StoreLE32(x[i] + State[i], Output + (i * 4));
+
+			memset(x, 0, sizeof(x));
+		}
+
+		void ChaChaTransform(uint32_t* State, byte* Output, size_t Length)
+		{
+			const size_t BLKSZE = 64;
+
+			while (Length >= BLKSZE)
+			{
+				ChaChaBlock(State, Output);
+				// 64bit block counter in words 12 and 13
+				if (++State[12] == 0)
+					++State[13];
+
+				Output += BLKSZE;
+				Length -= BLKSZE;
+			}
+
+			if (Length != 0)
+			{
+				byte tmp[BLKSZE];
+				ChaChaBlock(State, tmp);
+				if (++State[12] == 0)
+					++State[13];
+
+				memcpy(Output, tmp, Length);
+				memset(tmp, 0, sizeof(tmp));
+			}
+		}
+
+		void ChaChaKey(uint32_t* State, const byte* Seed)
+		{
+			// "expand 32-byte k"
+			State[0] = 0x61707865;
+			State[1] = 0x3320646E;
+			State[2] = 0x79622D32;
+			State[3] = 0x6B206574;
+
+			for (size_t i = 0; i < 8; ++i)
+				State[4 + i] = LoadLE32(Seed + (i * 4));
+
+			// the remaining 128 seed bits initialize the 64bit block counter and the 64bit nonce
+			for (size_t i = 0; i < 4; ++i)
+				State[12 + i] = LoadLE32(Seed + 32 + (i * 4));
+		}
+
+		// RFC 7539 2.3.2; key 00..1F, block counter 1, nonce 000000090000004A00000000. The rfc's 32bit counter and 96bit nonce
+		// occupy the same state words as the 64bit counter and nonce, so the seed tail is the counter followed by the nonce
+		const byte CHACHA_KAT_SEED[48] =
+		{
+			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+			0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F,
+			0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4A, 0x00, 0x00, 0x00, 0x00
+		};
+
+		const byte CHACHA_KAT_BLOCK[64] =
+		{
+			0x10, 0xF1, 0xE7, 0xE4, 0xD1, 0x3B, 0x59, 0x15, 0x50, 0x0F, 0xDD, 0x1F, 0xA3, 0x20, 0x71, 0xC4,
+			0xC7, 0xD1, 0xF4, 0xC7, 0x33, 0xC0, 0x68, 0x03, 0x04, 0x22, 0xAA, 0x9A, 0xC3, 0xD4, 0x6C, 0x4E,
+			0xD2, 0x82, 0x64, 0x46, 0x07, 0x9F, 0xAA, 0x09, 0x14, 0xC2, 0xD7, 0x05, 0xD9, 0x8B, 0x02, 0xA2,
+			0xB5, 0x12, 0x9C, 0xD1, 0xDE, 0x16, 0x4E, 0xB9, 0xCB, 0xD0, 0x83, 0xE8, 0xA2, 0x50, 0x3C, 0x4E
+		};
+
+		// RFC 7539 A.1 vectors 1 and 2; the all zero key and nonce at block counters 0 and 1, generated as one run to step the counter
+		const byte CHACHA_KAT_ZERO[128] =
+		{
+			0x76, 0xB8, 0xE0, 0xAD, 0xA0, 0xF1, 0x3D, 0x90, 0x40, 0x5D, 0x6A, 0xE5, 0x53, 0x86, 0xBD, 0x28,
+			0xBD, 0xD2, 0x19, 0xB8, 0xA0, 0x8D, 0xED, 0x1A, 0xA8, 0x36, 0xEF, 0xCC, 0x8B, 0x77, 0x0D, 0xC7,
+			0xDA, 0x41, 0x59, 0x7C, 0x51, 0x57, 0x48, 0x8D, 0x77, 0x24, 0xE0, 0x3F, 0xB8, 0xD8, 0x4A, 0x37,
+			0x6A, 0x43, 0xB8, 0xF4, 0x15, 0x18, 0xA1, 0x1C, 0xC3, 0x87, 0xB6, 0x69, 0xB2, 0xEE, 0x65, 0x86,
+			0x9F, 0x07, 0xE7, 0xBE, 0x55, 0x51, 0x38, 0x7A, 0x98, 0xBA, 0x97, 0x7C, 0x73, 0x2D, 0x08, 0x0D,
+			0xCB, 0x0F, 0x29, 0xA0, 0x48, 0xE3, 0x65, 0x69, 0x12, 0xC6, 0x53, 0x3E, 0x32, 0xEE, 0x7A, 0xED,
+			0x29, 0xB7, 0x21, 0x76, 0x9C, 0xE6, 0x4E, 0x43, 0xD5, 0x71, 0x33, 0xB0, 0x74, 0xD8, 0x39, 0xD5,
+			0x31, 0xED, 0x1F, 0x28, 0x51, 0x0A, 0xFB, 0x45, 0xAC, 0xE1, 0x0A, 0x1F, 0x4B, 0x79, 0x4D, 0x6F
+		};
+
+#if defined(CEX_SEEDED_AESNI)
+		const size_t AESNI_ROUNDKEYS = 15;
+
+		// FIPS-197 C.3; the AES-256 cipher example, key 00..1F
+		const byte AES_KAT_KEY[32] =
+		{
+			0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F,
+			0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F
+		};
+
+		const byte AES_KAT_INPUT[16] =
+		{
+			0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+		};
+
+		const byte AES_KAT_OUTPUT[16] =
+		{
+			0x8E, 0xA2, 0xB7, 0xCA, 0x51, 0x67, 0x45, 0xBF, 0xEA, 0xFC, 0x49, 0x90, 0x4B, 0x49, 0x60, 0x89
+		};
+
+		CEX_TARGET_ISA("sse2,aes")
+		inline __m128i AesExpandA(__m128i Key, __m128i Assist)
+		{
+			Assist = _mm_shuffle_epi32(Assist, 0xFF);
+			__m128i tmp = _mm_slli_si128(Key, 0x04);
+			Key = _mm_xor_si128(Key, tmp);
+			tmp = _mm_slli_si128(tmp, 0x04);
+			Key = _mm_xor_si128(Key, tmp);
+			tmp = _mm_slli_si128(tmp, 0x04);
+			Key = _mm_xor_si128(Key, tmp);
+
+			return _mm_xor_si128(Key, Assist);
+		}
+
+		CEX_TARGET_ISA("sse2,aes")
+		inline __m128i AesExpandB(__m128i Previous, __m128i Key)
+		{
+			__m128i assist = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(Previous, 0x00), 0xAA);
+			__m128i tmp = _mm_slli_si128(Key, 0x04);
+			Key = _mm_xor_si128(Key, tmp);
+			tmp = _mm_slli_si128(tmp, 0x04);
+			Key = _mm_xor_si128(Key, tmp);
+			tmp = _mm_slli_si128(tmp, 0x04);
+			Key = _mm_xor_si128(Key, tmp);
+
+			return _mm_xor_si128(Key, assist);
+		}
+
+		CEX_TARGET_ISA("sse2,aes")
+		void AesNiExpandKey(const byte* Key, byte* RoundKeys)
+		{
+			__m128i* rk = reinterpret_cast<__m128i*>(RoundKeys);
+			__m128i k1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key));
+			__m128i k2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Key + 16));
+
+			// the key generation assist requires an immediate round constant, so the schedule is unrolled
+			_mm_store_si128(rk, k1);
+			_mm_store_si128(rk + 1, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x01));
+			_mm_store_si128(rk + 2, k1);
+			k2 = AesExpandB(k1, k2);
+			_mm_store_si128(rk + 3, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x02));
+			_mm_store_si128(rk + 4, k1);
+			k2 = AesExpandB(k1, k2);
+			_mm_store_si128(rk + 5, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x04));
+			_mm_store_si128(rk + 6, k1);
+			k2 = AesExpandB(k1, k2);
+			_mm_store_si128(rk + 7, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x08));
+			_mm_store_si128(rk + 8, k1);
+			k2 = AesExpandB(k1, k2);
+			_mm_store_si128(rk + 9, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x10));
+			_mm_store_si128(rk + 10, k1);
+			k2 = AesExpandB(k1, k2);
+			_mm_store_si128(rk + 11, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x20));
+			_mm_store_si128(rk + 12, k1);
+			k2 = AesExpandB(k1, k2);
+			_mm_store_si128(rk + 13, k2);
+			k1 = AesExpandA(k1, _mm_aeskeygenassist_si128(k2, 0x40));
+			_mm_store_si128(rk + 14, k1);
+		}
+
+		CEX_TARGET_ISA("sse2,aes")
+		void AesNiCtr(const byte* RoundKeys, uint64_t* Counter, byte* Output, size_t Length)
+		{
+			__m128i rk[AESNI_ROUNDKEYS];
+
+			for (size_t i = 0; i < AESNI_ROUNDKEYS; ++i)
+				rk[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(RoundKeys) + i);
+
+			// four independent counter blocks per iteration keep the aes pipeline full;
+			// the low 64 bits of the counter increment, the high 64 bits hold the seeded nonce
+			while (Length >= 64)
+			{
+				__m128i b0 = _mm_set_epi64x(static_cast<int64_t>(Counter[1]), static_cast<int64_t>(Counter[0]));
+				__m128i b1 = _mm_set_epi64x(static_cast<int64_t>(Counter[1]), static_cast<int64_t>(Counter[0] + 1));
+				__m128i b2 = _mm_set_epi64x(static_cast<int64_t>(Counter[1]), static_cast<int64_t>(Counter[0] + 2));
+				__m128i b3 = _mm_set_epi64x(static_cast<int64_t>(Counter[1]), static_cast<int64_t>(Counter[0] + 3));
+				Counter[0] += 4;
+
+				b0 = _mm_xor_si128(b0, rk[0]);
+				b1 = _mm_xor_si128(b1, rk[0]);
+				b2 = _mm_xor_si128(b2, rk[0]);
+				b3 = _mm_xor_si128(b3, rk[0]);
+
+				for (size_t i = 1; i < AESNI_ROUNDKEYS - 1; ++i)
+				{
+					b0 = _mm_aesenc_si128(b0, rk[i]);
+					b1 = _mm_aesenc_si128(b1, rk[i]);
+					b2 = _mm_aesenc_si128(b2, rk[i]);
+					b3 = _mm_aesenc_si128(b3, rk[i]);
+				}
+
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Output), _mm_aesenclast_si128(b0, rk[AESNI_ROUNDKEYS - 1]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + 16), _mm_aesenclast_si128(b1, rk[AESNI_ROUNDKEYS - 1]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + 32), _mm_aesenclast_si128(b2, rk[AESNI_ROUNDKEYS - 1]));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(Output + 48), _mm_aesenclast_si128(b3, rk[AESNI_ROUNDKEYS - 1]));
+				Output += 64;
+				Length -= 64;
+			}
+
+			while (Length != 0)
+			{
+				CEX_ALIGN_DATA(16) byte tmp[16];
+				__m128i blk = _mm_set_epi64x(static_cast<int64_t>(Counter[1]), static_cast<int64_t>(Counter[0]));
+				++Counter[0];
+
+				blk = _mm_xor_si128(blk, rk[0]);
+				for (size_t i = 1; i < AESNI_ROUNDKEYS - 1; ++i)
+					blk = _mm_aesenc_si128(blk, rk[i]);
+				_mm_store_si128(reinterpret_cast<__m128i*>(tmp), _mm_aesenclast_si128(blk, rk[AESNI_ROUNDKEYS - 1]));
+
+				const size_t RMD = (Length < 16) ? Length : 16;
+				memcpy(Output, tmp, RMD);
+				memset(tmp, 0, sizeof(tmp));
+				Output += RMD;
+				Length -= RMD;
+			}
+
+			for (size_t i = 0; i < AESNI_ROUNDKEYS; ++i)
+				rk[i] = _mm_setzero_si128();
+		}
+#endif
+	}
+
+	//~~~Public Methods~~~//
+
+	void SeededCJP::Destroy()
+	{
+		Clear();
+
+		if (m_entropy)
+			m_entropy->Destroy();
+
+		m_isAvailable = false;
+		m_reseedBytes = 0;
+		m_reseedMilliseconds = 0;
+	}
+
+	void SeededCJP::GetBytes(std::vector<byte> &Output)
+	{
+		ThrowIfFailed("SeededCJP:GetBytes");
+
+		if (Output.size() != 0)
+			Generate(&Output[0], Output.size());
+	}
+
+	void SeededCJP::GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length)
+	{
+		ThrowIfFailed("SeededCJP:GetBytes");
+		if (Offset + Length > Output.size())
+			throw CryptoRandomException("SeededCJP:GetBytes", "The array is too small to fulfill this request!");
+
+		if (Length != 0)
+			Generate(&Output[Offset], Length);
+	}
+
+	void SeededCJP::GetBytes(byte* Output, size_t Length)
+	{
+		ThrowIfFailed("SeededCJP:GetBytes");
+		if (Output == 0 && Length != 0)
+			throw CryptoRandomException("SeededCJP:GetBytes", "The output pointer can not be null!");
+
+		if (Length != 0)
+			Generate(Output, Length);
+	}
+
+	std::vector<byte> SeededCJP::GetBytes(size_t Length)
+	{
+		ThrowIfFailed("SeededCJP:GetBytes");
+
+		std::vector<byte> data(Length);
+
+		if (Length != 0)
+			Generate(&data[0], data.size());
+
+		return data;
+	}
+
+	uint32_t SeededCJP::Next()
+	{
+		ThrowIfFailed("SeededCJP:Next");
+
+		uint32_t rnd = 0;
+		Generate(reinterpret_cast<byte*>(&rnd), sizeof(uint32_t));
+
+		return rnd;
+	}
+
+	void SeededCJP::Reseed()
+	{
+		ThrowIfFailed("SeededCJP:Reseed");
+
+		byte seed[SEED_SIZE];
+		m_entropy->GetBytes(seed, SEED_SIZE);
+
+		// combine the new jitter seed with the current keystream, so that a reseed can never reduce the state entropy
+		if (m_isSeeded)
+		{
+			byte prev[SEED_SIZE];
+			Transform(prev, SEED_SIZE);
+
+			for (size_t i = 0; i < SEED_SIZE; ++i)
+				seed[i] ^= prev[i];
+
+			memset(prev, 0, SEED_SIZE);
+		}
+
+		Rekey(seed);
+		memset(seed, 0, SEED_SIZE);
+
+		m_isSeeded = true;
+		m_reseedCounter = 0;
+		m_seedTime = std::chrono::steady_clock::now();
+	}
+
+	void SeededCJP::Reset()
+	{
+		// the seed provider clears its health test state; the keystream is discarded so the next request harvests a fresh seed
+		m_entropy->Reset();
+		Clear();
+	}
+
+	bool SeededCJP::SelfTest(DrbgEngines Engine)
+	{
+		if (Engine == DrbgEngines::Auto || !Supported(Engine))
+			return false;
+
+		if (Engine == DrbgEngines::AesCtr)
+		{
+#if defined(CEX_SEEDED_AESNI)
+			CEX_ALIGN_DATA(16) byte rk[AESNI_ROUNDKEYS * 16];
+			byte otp[80];
+			byte ref[80];
+			uint64_t ctr[2];
+
+			// the counter block is the two 64bit counter words in little endian order, so loading the plaintext as the counter encrypts it
+			AesNiExpandKey(AES_KAT_KEY, rk);
+			memcpy(ctr, AES_KAT_INPUT, sizeof(ctr));
+			AesNiCtr(rk, ctr, otp, 16);
+
+			if (memcmp(otp, AES_KAT_OUTPUT, sizeof(AES_KAT_OUTPUT)) != 0)
+				return false;
+
+			// the four block pipeline and the tail must produce the same keystream as one block at a time
+			memcpy(ctr, AES_KAT_INPUT, sizeof(ctr));
+			AesNiCtr(rk, ctr, otp, sizeof(otp));
+			memcpy(ctr, AES_KAT_INPUT, sizeof(ctr));
+
+			for (size_t i = 0; i < sizeof(ref); i += 16)
+				AesNiCtr(rk, ctr, ref + i, 16);
+
+			const bool AESVLD = memcmp(otp, ref, sizeof(otp)) == 0;
+			memset(rk, 0, sizeof(rk));
+
+			return AESVLD;
+#else
+			return false;
+#endif
+		}
+
+		uint32_t state[16];
+		byte otp[128];
+
+		ChaChaKey(state, CHACHA_KAT_SEED);
+		ChaChaTransform(state, otp, sizeof(CHACHA_KAT_BLOCK));
+
+		if (memcmp(otp, CHACHA_KAT_BLOCK, sizeof(CHACHA_KAT_BLOCK)) != 0)
+			return false;
+
+		const byte ZEROES[48] = { 0 };
+		ChaChaKey(state, ZEROES);
+		ChaChaTransform(state, otp, sizeof(CHACHA_KAT_ZERO));
+
+		return memcmp(otp, CHACHA_KAT_ZERO, sizeof(CHACHA_KAT_ZERO)) == 0;
+	}
+
+	bool SeededCJP::Supported(DrbgEngines Engine)
+	{
+		if (Engine != DrbgEngines::AesCtr)
+			return true;
+
+		bool hasAesni = false;
+
+#if defined(CEX_SEEDED_AESNI)
+		try
+		{
+			hasAesni = CpuDetect::Snapshot()->AESNI();
+		}
+		catch (...)
+		{
+			hasAesni = false;
+		}
+#endif
+
+		return hasAesni;
+	}
+
+	//~~~Private Methods~~~//
+
+	void SeededCJP::Clear()
+	{
+		memset(m_aesRoundKeys, 0, sizeof(m_aesRoundKeys));
+		memset(m_aesCounter, 0, sizeof(m_aesCounter));
+		memset(m_chachaState, 0, sizeof(m_chachaState));
+		m_isSeeded = false;
+		m_reseedCounter = 0;
+	}
+
+	void SeededCJP::Generate(byte* Output, size_t Length)
+	{
+		byte* const OUTPTR = Output;
+		const size_t OUTLEN = Length;
+
+		try
+		{
+			while (Length != 0)
+			{
+				const bool TIMEOUT = m_reseedMilliseconds != 0 &&
+					std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_seedTime).count() >= static_cast<long long>(m_reseedMilliseconds);
+
+				if (!m_isSeeded || m_reseedCounter >= m_reseedBytes || TIMEOUT)
+					Reseed();
+
+				// never expand a single seed past the byte budget, even within one request
+				const size_t BUDGET = (m_reseedBytes > m_reseedCounter) ? m_reseedBytes - m_reseedCounter : Length;
+				const size_t PRCLEN = (Length < BUDGET) ? Length : BUDGET;
+
+				Transform(Output, PRCLEN);
+				m_reseedCounter += PRCLEN;
+				Output += PRCLEN;
+				Length -= PRCLEN;
+			}
+		}
+		catch (...)
+		{
+			// a reseed failed partway through the request, as CJP on a health failure; nothing of the request leaves the generator, and the keystream is discarded
+			memset(OUTPTR, 0, OUTLEN);
+			Clear();
+			throw;
+		}
+
+		// fast key erasure; replace the key with fresh keystream so the state in memory can not reproduce the output just returned
+		byte key[SEED_SIZE];
+		Transform(key, SEED_SIZE);
+		Rekey(key);
+		memset(key, 0, SEED_SIZE);
+	}
+
+	void SeededCJP::Initialize()
+	{
+		m_isAvailable = m_entropy->IsAvailable();
+
+		const bool HASAES = Supported(DrbgEngines::AesCtr);
+
+		if (m_engine == DrbgEngines::Auto)
+			m_engine = HASAES ? DrbgEngines::AesCtr : DrbgEngines::ChaCha20;
+		else if (m_engine == DrbgEngines::AesCtr && !HASAES)
+			throw CryptoRandomException("SeededCJP:Initialize", "The AES-CTR engine requires a processor and build with AES-NI support!");
+	}
+
+	void SeededCJP::Rekey(const byte* Seed)
+	{
+		if (m_engine == DrbgEngines::AesCtr)
+		{
+#if defined(CEX_SEEDED_AESNI)
+			AesNiExpandKey(Seed, m_aesRoundKeys);
+#endif
+			memcpy(m_aesCounter, Seed + KEY_SIZE, NONCE_SIZE);
+		}
+		else
+		{
+			ChaChaKey(m_chachaState, Seed);
+		}
+	}
+
+	void SeededCJP::Transform(byte* Output, size_t Length)
+	{
+#if defined(CEX_SEEDED_AESNI)
+		if (m_engine == DrbgEngines::AesCtr)
+		{
+			AesNiCtr(m_aesRoundKeys, m_aesCounter, Output, Length);
+			return;
+		}
+#endif
+		ChaChaTransform(m_chachaState, Output, Length);
+	}
+
+	void SeededCJP::ThrowIfFailed(const std::string &Method)
+	{
+		if (!m_isAvailable)
+			throw CryptoRandomException(Method, "High resolution timer not available or too coarse for RNG!");
+
+		// the seed provider latches a health failure; the keystream must not outlive it until the next scheduled reseed
+		if (m_entropy->Health() != HealthStatus::Ok)
+			throw CryptoRandomException(Method, "The continuous health test of the seed provider has failed, the generator must be Reset!", HealthTest::Name(m_entropy->Health()));
+		if (!m_entropy->IsAvailable())
+			throw CryptoRandomException(Method, "High resolution timer not available or too coarse for RNG!");
+	}
+}
@@ -0,0 +1,290 @@
+#ifndef _CEXENGINE_SEEDEDCJP_H
+#define _CEXENGINE_SEEDEDCJP_H
+
+#include "Config.h"
+#include "CJP.h"
+#include <chrono>
+#include <memory>
+
+namespace CpuJitter
+{
+	/// <summary>
+	/// A jitter seeded deterministic random bit generator (seeded expansion mode).
+	/// <para>A CJP instance harvests a 384 bit seed which keys a fast keystream generator; AES-256 in counter mode when the processor supports AES-NI, otherwise ChaCha20.
+	/// The generator is rekeyed from its own keystream after every request so that a compromised state can not reveal earlier output,
+	/// and is reseeded from the jitter source after a configurable number of output bytes or elapsed time.
+	/// This mode trades the one-bit-per-measurement rate of the raw provider for memory-bandwidth-class throughput,
+	/// the entropy of the output is bounded by the entropy of the jitter seeds.</para>
+	/// </summary>
+	///
+	/// <example>
+	/// <description>Example of generating a large buffer:</description>
+	/// <code>
+	/// std:vector&lt;uint8_t&gt; output(1024 * 1000 * 10);
+	/// SeededCJP gen;
+	/// gen.GetBytes(output);
+	/// </code>
+	/// </example>
+	class SeededCJP
+	{
+	public:
+
+		/// <summary>
+		/// The keystream generators available to the expansion mode
+		/// </summary>
+		enum class DrbgEngines : int
+		{
+			/// <summary>
+			/// Select AesCtr when the processor supports AES-NI, otherwise ChaCha20
+			/// </summary>
+			Auto = 0,
+			/// <summary>
+			/// AES-256 in counter mode using the AES-NI instructions
+			/// </summary>
+			AesCtr = 1,
+			/// <summary>
+			/// The portable ChaCha20 stream cipher with a 64bit block counter
+			/// </summary>
+			ChaCha20 = 2
+		};
+
+	private:
+		static constexpr size_t AES_ROUNDKEYS = 15;
+		static constexpr size_t KEY_SIZE = 32;
+		static constexpr size_t NONCE_SIZE = 16;
+		static constexpr size_t SEED_SIZE = KEY_SIZE + NONCE_SIZE;
+		const size_t RESEED_BYTES = 1024 * 1024 * 16;
+		const size_t RESEED_MILLISECONDS = 60000;
+
+		CEX_ALIGN_DATA(16) byte m_aesRoundKeys[AES_ROUNDKEYS * 16];
+		uint64_t m_aesCounter[2];
+		uint32_t m_chachaState[16];
+		DrbgEngines m_engine;
+		std::unique_ptr<CJP> m_entropy;
+		bool m_isAvailable;
+		bool m_isSeeded;
+		size_t m_reseedBytes;
+		size_t m_reseedCounter;
+		size_t m_reseedMilliseconds;
+		std::chrono::steady_clock::time_point m_seedTime;
+
+	public:
+
+		SeededCJP(const SeededCJP&) = delete;
+		SeededCJP& operator=(const SeededCJP&) = delete;
+		SeededCJP& operator=(SeededCJP&&) = delete;
+
+		//~~~Properties~~~//
+
+		/// <summary>
+		/// Get/Set: Enable the memory access noise source of the seed provider
+		/// </summary>
+		bool &EnableAccess() { return m_entropy->EnableAccess(); }
+
+		/// <summary>
+		/// Get/Set: Enable the Von Neumann debiasing extractor of the seed provider
+		/// </summary>
+		bool &EnableDebias() { return m_entropy->EnableDebias(); }
+
+		/// <summary>
+		/// Get/Set: Run the streaming min-entropy estimators on the seed provider's measurements; disabled by default
+		/// </summary>
+		bool &EnableEstimator() { return m_entropy->EnableEstimator(); }
+
+		/// <summary>
+		/// Get: The min-entropy estimates over the seed provider's most recent measurements; all zero unless EnableEstimator is set
+		/// </summary>
+		const EntropyEstimate Estimate() { return m_entropy->Estimate(); }
+
+		/// <summary>
+		/// Get/Set: The debiasing extractor of the seed provider
+		/// </summary>
+		Extractors &Extractor() { return m_entropy->Extractor(); }
+
+		/// <summary>
+		/// Get/Set: The entropy bits credited per timing measurement by the seed provider; values above 1 enable harvest mode
+		/// </summary>
+		uint32_t &HarvestBits() { return m_entropy->HarvestBits(); }
+
+		/// <summary>
+		/// Get: The keystream generator in use
+		/// </summary>
+		const DrbgEngines Engine() { return m_engine; }
+
+		/// <summary>
+		/// Get: The state of the seed provider's continuous health tests; a failure fails every request until Reset
+		/// </summary>
+		const HealthStatus Health() { return m_entropy->Health(); }
+
+		/// <summary>
+		/// Get: The entropy provider is available on this system.
+		/// <para>This value should be tested after class instantiation and before a request for data is made.</para>
+		/// </summary>
+		const bool IsAvailable() { return m_isAvailable && m_entropy->IsAvailable(); }
+
+		/// <summary>
+		/// Get/Set: The page backing of the seed provider's memory noise buffer; takes effect at the next Reset
+		/// </summary>
+		HugePages &MemoryPages() { return m_entropy->MemoryPages(); }
+
+		/// <summary>
+		/// Get/Set: The NUMA node placement of the seed provider's memory noise buffer; takes effect at the next Reset
+		/// </summary>
+		NumaPlacements &MemoryPlacement() { return m_entropy->MemoryPlacement(); }
+
+		/// <summary>
+		/// Get/Set: The memory level targeted by the seed provider's memory noise source; takes effect at the next Reset
+		/// </summary>
+		MemoryTargets &MemoryTarget() { return m_entropy->MemoryTarget(); }
+
+		/// <summary>
+		/// Get: Provider name
+		/// </summary>
+		const char* Name() { return "SeededCJP"; }
+
+		/// <summary>
+		/// Get/Set: The oversampling rate used by the seed provider when harvesting a seed
+		/// </summary>
+		uint32_t &OverSampleRate() { return m_entropy->OverSampleRate(); }
+
+		/// <summary>
+		/// Get: The smallest seed provider OverSampleRate supported by the measured min-entropy; 0 until the estimator window is full, see CJP::RequiredOverSampleRate
+		/// </summary>
+		const uint32_t RequiredOverSampleRate() { return m_entropy->RequiredOverSampleRate(); }
+
+		/// <summary>
+		/// Get/Set: The number of output bytes after which a new jitter seed is harvested; the default is 16mib
+		/// </summary>
+		size_t &ReseedBytes() { return m_reseedBytes; }
+
+		/// <summary>
+		/// Get/Set: The number of milliseconds after which a new jitter seed is harvested; the default is 60 seconds, zero disables the time budget
+		/// </summary>
+		size_t &ReseedMilliseconds() { return m_reseedMilliseconds; }
+
+		/// <summary>
+		/// Get: The hot path counters of the seed provider; all zero unless built with CEX_CJP_STATISTICS, see CJP::Statistics
+		/// </summary>
+		const JitterStatistics Statistics() { return m_entropy->Statistics(); }
+
+		//~~~Constructor~~~//
+
+		/// <summary>
+		/// Instantiate this class
+		/// </summary>
+		///
+		/// <param name="Engine">The keystream generator; Auto selects AES-CTR on processors with AES-NI</param>
+		///
+		/// <exception cref="CryptoRandomException">Thrown if AesCtr is requested on a processor or build without AES-NI</exception>
+		explicit SeededCJP(DrbgEngines Engine = DrbgEngines::Auto)
+			:
+			m_aesCounter{ 0, 0 },
+			m_chachaState{ 0 },
+			m_engine(Engine),
+			m_entropy(new CJP()),
+			m_isAvailable(false),
+			m_isSeeded(false),
+			m_reseedBytes(RESEED_BYTES),
+			m_reseedCounter(0),
+			m_reseedMilliseconds(RESEED_MILLISECONDS),
+			m_seedTime()
+		{
+			Initialize();
+		}
+
+		/// <summary>
+		/// Destructor
+		/// </summary>
+		~SeededCJP()
+		{
+			Destroy();
+		}
+
+		//~~~Public Methods~~~//
+
+		/// <summary>
+		/// Release all resources associated with the object
+		/// </summary>
+		void Destroy();
+
+		/// <summary>
+		/// Fill a buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		void GetBytes(std::vector<byte> &Output);
+
+		/// <summary>
+		/// Fill the buffer with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">The output array to fill</param>
+		/// <param name="Offset">The starting position within the Output array</param>
+		/// <param name="Length">The number of bytes to write to the Output array</param>
+		void GetBytes(std::vector<byte> &Output, size_t Offset, size_t Length);
+
+		/// <summary>
+		/// Fill a caller owned memory region with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Output">Pointer to the first byte of the output region</param>
+		/// <param name="Length">The number of bytes to write to the Output region</param>
+		void GetBytes(byte* Output, size_t Length);
+
+		/// <summary>
+		/// Return an array with pseudo-random bytes
+		/// </summary>
+		///
+		/// <param name="Length">The size of the expected array returned</param>
+		///
+		/// <returns>An array of pseudo-random of bytes</returns>
+		std::vector<byte> GetBytes(size_t Length);
+
+		/// <summary>
+		/// Returns a pseudo-random unsigned 32bit integer
+		/// </summary>
+		uint32_t Next();
+
+		/// <summary>
+		/// Harvest a new seed from the jitter source and rekey the generator
+		/// </summary>
+		void Reseed();
+
+		/// <summary>
+		/// Reset the seed provider, clearing a latched health test failure, and discard the keystream; the next request harvests a new seed
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Run the known answer tests of a keystream generator; the FIPS-197 AES-256 example through the counter mode path, or the RFC 7539 ChaCha20 block vectors
+		/// </summary>
+		///
+		/// <param name="Engine">The keystream generator to test</param>
+		///
+		/// <returns>Returns false if the generator is Auto or unsupported, or its output differs from the reference</returns>
+		static bool SelfTest(DrbgEngines Engine);
+
+		/// <summary>
+		/// The keystream generator can be used on this processor and build; AesCtr requires AES-NI
+		/// </summary>
+		///
+		/// <param name="Engine">The keystream generator</param>
+		static bool Supported(DrbgEngines Engine);
+
+		/// <summary>
+		/// Zero the hot path counters of the seed provider
+		/// </summary>
+		void ResetStatistics() { m_entropy->ResetStatistics(); }
+
+	private:
+
+		void Clear();
+		void Generate(byte* Output, size_t Length);
+		void Initialize();
+		void Rekey(const byte* Seed);
+		void ThrowIfFailed(const std::string &Method);
+		void Transform(byte* Output, size_t Length);
+	};
+
+}
+#endif
@@ -6,8 +6,12 @@
 #include <stdio.h>
 #include "ConsoleUtils.h"
 #include "../CpuJitter/Config.h"
+#include "../CpuJitter/CaptureReader.h"
 #include "../CpuJitter/CJP.h"
 #include "../CpuJitter/FileStream.h"
+#include "../CpuJitter/IsaDispatch.h"
+#include "../CpuJitter/PoolMixer.h"
+#include "../CpuJitter/SeededCJP.h"
 
 #if defined(CEX_OS_WINDOWS)
 #	include <direct.h>
@@ -80,33 +84,106 @@ void CloseApp()
 	exit(0);
 }
 
-void CJPGenerateFile(std::string FilePath, size_t FileSize)
+template <typename T>
+void WriteRandom(T* Provider, CpuJitter::FileStream &Stream, size_t FileSize)
 {
-	CpuJitter::CJP* pvd = new CpuJitter::CJP();
 	std::vector<byte> output(1024);
 	size_t prcLen = FileSize;
-	CpuJitter::FileStream fs(FilePath, CpuJitter::FileStream::FileAccess::Write);
-	pvd->EnableDebias() = false;
-	pvd->EnableAccess() = false;
 
 	do
 	{
-		pvd->GetBytes(output);
+		Provider->GetBytes(output);
 		size_t rmd = Min(output.size(), prcLen);
-		fs.Write(output, 0, rmd);
+		Stream.Write(output, 0, rmd);
 		prcLen -= rmd;
 	} 
 	while (prcLen != 0);
+}
+
+void CJPGenerateFile(std::string FilePath, size_t FileSize, bool SeededExpansion = false)
+{
+	CpuJitter::FileStream fs(FilePath, CpuJitter::FileStream::FileAccess::Write);
+
+	if (SeededExpansion)
+	{
+		// jitter seeds expanded through the seeded drbg
+		CpuJitter::SeededCJP* pvd = new CpuJitter::SeededCJP();
+		WriteRandom(pvd, fs, FileSize);
+		delete pvd;
+	}
+	else
+	{
+		CpuJitter::CJP* pvd = new CpuJitter::CJP();
+		pvd->EnableDebias() = false;
+		pvd->EnableAccess() = false;
+		WriteRandom(pvd, fs, FileSize);
+		delete pvd;
+	}
 
 	fs.Flush();
 	fs.Close();
+}
 
+void CJPCaptureFile(std::string FilePath, uint64_t Samples)
+{
+	// raw timing deltas of the default configuration, with the memory access time of each measurement
+	CpuJitter::CJP* pvd = new CpuJitter::CJP();
+	pvd->Capture(FilePath, Samples, true);
 	delete pvd;
+
+	CpuJitter::CaptureReader reader;
+	reader.Open(FilePath);
+	PrintHeader("Captured " + std::to_string(reader.Samples()) + " samples in " + std::to_string(reader.Blocks()) + " blocks", "");
+}
+
+void MixerSelfTest()
+{
+	// known answer tests of every pool mixing kernel against the scalar reference
+	const CpuJitter::MixKernels KERNELS[] = { CpuJitter::MixKernels::Scalar, CpuJitter::MixKernels::Portable, CpuJitter::MixKernels::Avx2, CpuJitter::MixKernels::Clmul };
+
+	PrintHeader("Pool mixer known answer tests:", "");
+
+	for (size_t i = 0; i < sizeof(KERNELS) / sizeof(KERNELS[0]); ++i)
+	{
+		std::string name(CpuJitter::PoolMixer::Name(KERNELS[i]));
+
+		if (CpuJitter::PoolMixer::Function(KERNELS[i]) == 0)
+			PrintHeader(name + ": not supported", "");
+		else
+			PrintHeader(name + (CpuJitter::PoolMixer::SelfTest(KERNELS[i]) ? ": passed" : ": FAILED"), "");
+	}
+
+	PrintHeader(std::string("Dispatch tier: ") + CpuJitter::IsaDispatch::Name(CpuJitter::IsaDispatch::Tier()) + " (detected " + CpuJitter::IsaDispatch::Name(CpuJitter::IsaDispatch::Detected()) + ")", "");
+	PrintHeader(std::string("Selected kernel: ") + CpuJitter::PoolMixer::Name(CpuJitter::PoolMixer::Select()), "");
+	ConsoleUtils::WriteLine("");
+}
+
+void SeededSelfTest()
+{
+	// known answer tests of the seeded expansion keystream generators
+	const CpuJitter::SeededCJP::DrbgEngines ENGINES[] = { CpuJitter::SeededCJP::DrbgEngines::AesCtr, CpuJitter::SeededCJP::DrbgEngines::ChaCha20 };
+	const char* NAMES[] = { "AES-256 CTR", "ChaCha20" };
+
+	PrintHeader("Seeded expansion known answer tests:", "");
+
+	for (size_t i = 0; i < sizeof(ENGINES) / sizeof(ENGINES[0]); ++i)
+	{
+		std::string name(NAMES[i]);
+
+		if (!CpuJitter::SeededCJP::Supported(ENGINES[i]))
+			PrintHeader(name + ": not supported", "");
+		else
+			PrintHeader(name + (CpuJitter::SeededCJP::SelfTest(ENGINES[i]) ? ": passed" : ": FAILED"), "");
+	}
+
+	ConsoleUtils::WriteLine("");
 }
 
 int main()
 {
 	PrintTitle();
+	MixerSelfTest();
+	SeededSelfTest();
 
 	std::string path = GetCurrentDirectory();
 
@@ -123,12 +200,27 @@ int main()
 		if (CanTest("Write random to file? Press Y to proceed, any other key to abort"))
 		{
 			const size_t FILESIZE = 1024 * 1000 * 10;
-			CJPGenerateFile(path, FILESIZE);
-			PrintHeader("Test completed. Press any key to close..", "");
+			bool seeded = CanTest("Use the jitter seeded DRBG expansion mode? Press Y to use it, any other key for raw CJP output");
+			CJPGenerateFile(path, FILESIZE, seeded);
+			PrintHeader("Test completed.", "");
+		}
+		else
+		{
+			PrintHeader("Test aborted.", "");
+		}
+
+		path = GetCurrentDirectory() + "\\cjp_capture.raw";
+		PrintHeader("Capture 16 million raw timing measurements to a file:", "");
+		PrintHeader("Path: " + path, "");
+
+		if (CanTest("Capture raw noise? Press Y to proceed, any other key to abort"))
+		{
+			CJPCaptureFile(path, 16 * 1024 * 1024);
+			PrintHeader("Capture completed. Press any key to close..", "");
 		}
 		else
 		{
-			PrintHeader("Test aborted. Press any key to close..", "");
+			PrintHeader("Capture aborted. Press any key to close..", "");
 		}
 		GetResponse();
 	}